@@ -0,0 +1,93 @@
+/*
+ -------------------------------------
+ File:    corpus.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+
+ Generated inputs of the benchmark and the tests, from one fixed random sequence, so
+ they are the same on every machine and in every program that uses them.
+
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "corpus.h"
+
+static unsigned long long seed = 0x9E3779B97F4A7C15ULL;
+
+/* Returns the next number of a fixed xorshift sequence */
+unsigned long long nextRandom(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+/* Fills the data with words picked from a skewed vocabulary */
+void makeText(unsigned char *data, size_t len) {
+	static const char *words[] = { "the", "of", "and", "to", "in", "a",
+			"is", "that", "for", "it", "as", "with", "was", "on", "be",
+			"huffman", "block", "table", "code", "length", "symbol", "tree" };
+	size_t nwords = sizeof(words) / sizeof(words[0]);
+	size_t pos = 0;
+
+	while (pos < len) {
+		//low indexes come up far more often
+		size_t w = (nextRandom() % nwords) * (nextRandom() % nwords) / nwords;
+		for (const char *c = words[w]; *c != '\0' && pos < len; c++)
+			data[pos++] = *c;
+		if (pos < len)
+			data[pos++] = nextRandom() % 12 == 0 ? '\n' : ' ';
+	}
+}
+
+/* Fills the data with timestamped log lines */
+void makeLog(unsigned char *data, size_t len) {
+	static const char *levels[] = { "INFO", "INFO", "INFO", "WARN", "ERROR" };
+	unsigned long long t = 1700000000;
+	size_t pos = 0;
+
+	while (pos < len) {
+		char line[128];
+		t += nextRandom() % 3;
+		int n = snprintf(line, sizeof(line),
+				"%llu [%s] worker-%llu request %llu took %llu ms\n", t,
+				levels[nextRandom() % 5], nextRandom() % 16,
+				nextRandom() % 100000, nextRandom() % 900);
+		for (int i = 0; i < n && pos < len; i++)
+			data[pos++] = (unsigned char) line[i];
+	}
+}
+
+/* Fills the data with bytes of a geometric distribution */
+void makeSkewed(unsigned char *data, size_t len) {
+	for (size_t i = 0; i < len; i++) {
+		unsigned long long r = nextRandom();
+		unsigned char b = 0;
+		while ((r & 1) == 0 && b < 255) {
+			r >>= 1;
+			b++;
+		}
+		data[i] = b;
+	}
+}
+
+/* Fills the data with uniformly random bytes, from the top bits, since the low ones of
+ neighbouring numbers only ever form half of the byte pairs */
+void makeRandom(unsigned char *data, size_t len) {
+	for (size_t i = 0; i < len; i++)
+		data[i] = (unsigned char) (nextRandom() >> 56);
+}
+
+/* Fills the data with text broken up by long runs of padding */
+void makeRuns(unsigned char *data, size_t len) {
+	makeText(data, len);
+	for (size_t pos = 0; pos < len; pos += 1 << 16) {
+		size_t run = (nextRandom() % 16) << 12;
+		memset(data + pos, ' ', pos + run < len ? run : len - pos);
+	}
+}
@@ -0,0 +1,23 @@
+/*
+ -------------------------------------
+ File:    corpus.h
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#ifndef CORPUS_H_
+#define CORPUS_H_
+
+#include <stddef.h>
+
+unsigned long long nextRandom(void);
+void makeText(unsigned char *data, size_t len);
+void makeLog(unsigned char *data, size_t len);
+void makeSkewed(unsigned char *data, size_t len);
+void makeRandom(unsigned char *data, size_t len);
+void makeRuns(unsigned char *data, size_t len);
+
+#endif /* CORPUS_H_ */
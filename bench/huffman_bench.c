@@ -0,0 +1,354 @@
+/*
+ -------------------------------------
+ File:    huffman_bench.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+
+ BENCHMARK USAGE: ./huffman_bench [-1..-9] [-w] [-n <runs>] [--record <file>]
+                   [--baseline <file>] [--tolerance <percent>] [files...]
+
+ Encodes and decodes every file in memory and prints the throughput and ratio of each,
+ keeping the best of the runs. Without files it uses a generated corpus of text, logs,
+ skewed binary, random bytes and padded runs, the same on every machine. Without a level
+ it runs levels 1, 5 and 9, with and without byte pairs, so every coding path is exercised,
+ which is what the profile guided build trains on.
+
+ With --record it writes the rates of encoding and decoding all of the files, at every
+ level it runs, to a baseline file. With --baseline it fails when either rate of a level
+ falls more than the tolerance, 20% by default, below the one in the baseline, which
+ makes it a throughput regression test for the machine the baseline was recorded on. A
+ baseline that does not exist yet is recorded instead.
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "block.h"
+#include "table.h"
+#include "corpus.h"
+
+#define CORPUS_SIZE	(1 << 21)	//bytes of each generated sample
+#define DEFAULT_RUNS	3
+#define DEFAULT_TOLERANCE	20	//percent a rate may fall below its baseline
+#define MAX_RATES	(2 * MAX_LEVEL)
+
+typedef struct Sample {
+	const char *name;
+	unsigned char *data;
+	size_t len;
+} Sample;
+
+typedef struct Rate {
+	int level;
+	bool word_symbols;
+	double encode;	//MB/s over all of the files
+	double decode;
+} Rate;
+
+/* Returns seconds on a monotonic clock */
+static double getTime() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* Reads a whole file into a sample */
+static bool loadSample(const char *name, Sample *sample) {
+	FILE *file = fopen(name, "rb");
+	if (file == NULL)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	sample->name = name;
+	sample->len = ftell(file);
+	sample->data = (unsigned char*) malloc(sample->len + 1);
+	fseek(file, 0, SEEK_SET);
+	bool success = sample->data != NULL
+			&& fread(sample->data, 1, sample->len, file) == sample->len;
+	fclose(file);
+	return success;
+}
+
+/* Encodes a sample into out as blocks back to back, returns their size */
+static size_t encodeSample(const Sample *sample, const EncodeOptions *options,
+		unsigned char *out) {
+	BlockState state = { NULL };
+	size_t size = 0;
+
+	for (size_t pos = 0; pos < sample->len;) {
+		unsigned int len = (unsigned int) (
+				sample->len - pos < options->block_size ?
+						sample->len - pos : options->block_size);
+		unsigned int seg = splitBlock(sample->data + pos, len, options);
+		size_t n = 0;
+		BlockType type;
+
+		if (!encodeBlock(sample->data + pos, seg, out + size, &n, options,
+				&state, &type))
+			break;
+		size += n;
+		pos += seg;
+	}
+
+	freeBlockState(&state);
+	return size;
+}
+
+/* Decodes the blocks of a sample into out, returns whether they make up the sample */
+static bool decodeSample(const Sample *sample, unsigned char *encoded,
+		size_t size, unsigned char *out) {
+	FILE *file = fmemopen(encoded, size, "rb");
+	BlockState state = { NULL };
+	size_t pos = 0;
+	bool success = file != NULL;
+
+	while (success && pos < sample->len) {
+		unsigned int len = 0;
+		BlockType type;
+		success = decodeBlock(file, out + pos, sample->len - pos, &state, &len,
+				&type);
+		pos += len;
+	}
+
+	freeBlockState(&state);
+	if (file != NULL)
+		fclose(file);
+	return success && memcmp(out, sample->data, sample->len) == 0;
+}
+
+/* Times the best of several encode and decode runs of a sample and prints them, adding
+ the best times to the totals */
+static bool benchSample(const Sample *sample, const EncodeOptions *options,
+		int level, int runs, double *encode_time, double *decode_time) {
+	size_t bound = sample->len
+			+ (sample->len / options->block_size + 1) * getEncodedBound(options);
+	unsigned char *encoded = (unsigned char*) malloc(bound);
+	unsigned char *decoded = (unsigned char*) malloc(sample->len + 1);
+	double best_encode = 0;
+	double best_decode = 0;
+	size_t size = 0;
+	bool success = encoded != NULL && decoded != NULL;
+
+	for (int r = 0; success && r < runs; r++) {
+		//every run starts from an empty cache, like a new process
+		clearTableCache();
+
+		double start = getTime();
+		size = encodeSample(sample, options, encoded);
+		double middle = getTime();
+		success = decodeSample(sample, encoded, size, decoded);
+		double end = getTime();
+
+		if (r == 0 || middle - start < best_encode)
+			best_encode = middle - start;
+		if (r == 0 || end - middle < best_decode)
+			best_decode = end - middle;
+	}
+
+	*encode_time += best_encode;
+	*decode_time += best_decode;
+	if (success)
+		printf("%-24s -%d %-5s %9.1f MB/s enc %9.1f MB/s dec %7.2f%%\n",
+				sample->name, level, options->word_symbols ? "pairs" : "bytes",
+				sample->len / best_encode / 1e6,
+				sample->len / best_decode / 1e6,
+				sample->len > 0 ? 100.0 * size / sample->len : 100.0);
+	else
+		printf("%-24s -%d ROUND TRIP FAILED\n", sample->name, level);
+
+	free(encoded);
+	free(decoded);
+	return success;
+}
+
+/* Reads the rates of a baseline file, returns how many there are or -1 when there is
+ no baseline to read */
+static int readBaseline(const char *name, Rate *rates) {
+	FILE *file = fopen(name, "r");
+	char symbols[8];
+	int n = 0;
+
+	if (file == NULL)
+		return -1;
+	while (n < MAX_RATES
+			&& fscanf(file, " -%d %7s %lf %lf", &rates[n].level, symbols,
+					&rates[n].encode, &rates[n].decode) == 4) {
+		rates[n].word_symbols = strcmp(symbols, "pairs") == 0;
+		n++;
+	}
+	fclose(file);
+	return n;
+}
+
+/* Writes the rates to a baseline file */
+static bool writeBaseline(const char *name, const Rate *rates, int n) {
+	FILE *file = fopen(name, "w");
+	if (file == NULL)
+		return false;
+	for (int i = 0; i < n; i++)
+		fprintf(file, "-%d %s %.1f %.1f\n", rates[i].level,
+				rates[i].word_symbols ? "pairs" : "bytes", rates[i].encode,
+				rates[i].decode);
+	return fclose(file) == 0;
+}
+
+/* Returns whether the rates of every level in the baseline are within the tolerance
+ of it, printing the ones that are not */
+static bool compareBaseline(const Rate *rates, int n, const Rate *baseline,
+		int nbaseline, double tolerance) {
+	bool success = true;
+	bool compared = false;
+
+	for (int i = 0; i < n; i++) {
+		for (int b = 0; b < nbaseline; b++) {
+			if (rates[i].level != baseline[b].level
+					|| rates[i].word_symbols != baseline[b].word_symbols)
+				continue;
+
+			double floor = 1 - tolerance / 100;
+			compared = true;
+			if (rates[i].encode < baseline[b].encode * floor
+					|| rates[i].decode < baseline[b].decode * floor) {
+				printf("ERROR: -%d %s is %.1f MB/s enc %.1f MB/s dec, more than %.0f%% "
+						"below the baseline of %.1f MB/s enc %.1f MB/s dec\n",
+						rates[i].level, rates[i].word_symbols ? "pairs" : "bytes",
+						rates[i].encode, rates[i].decode, tolerance,
+						baseline[b].encode, baseline[b].decode);
+				success = false;
+			}
+		}
+	}
+
+	if (!compared)
+		printf("ERROR: The baseline has none of the levels that ran\n");
+	return success && compared;
+}
+
+/* Main Function */
+int main(int argc, char **argv) {
+	Sample samples[64];
+	int nsamples = 0;
+	int level = 0;
+	bool word_symbols = false;
+	int runs = DEFAULT_RUNS;
+	const char *record = NULL;
+	const char *baseline = NULL;
+	double tolerance = DEFAULT_TOLERANCE;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-w") == 0) {
+			word_symbols = true;
+		} else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+			runs = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+			record = argv[++i];
+		} else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+			baseline = argv[++i];
+		} else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+			tolerance = atof(argv[++i]);
+		} else if (argv[i][0] == '-' && argv[i][1] >= '0' + MIN_LEVEL
+				&& argv[i][1] <= '0' + MAX_LEVEL && argv[i][2] == '\0') {
+			level = argv[i][1] - '0';
+		} else if (nsamples < 64 && loadSample(argv[i], &samples[nsamples])) {
+			nsamples++;
+		} else {
+			printf("ERROR: Cannot read %s\n", argv[i]);
+			return 1;
+		}
+	}
+	if (runs < 1)
+		runs = 1;
+
+	//the generated corpus, the same on every machine
+	if (nsamples == 0) {
+		static const char *names[] = { "text", "log", "skewed", "random",
+				"runs" };
+		void (*makers[])(unsigned char*, size_t) = { makeText, makeLog,
+				makeSkewed, makeRandom, makeRuns };
+		for (; nsamples < 5; nsamples++) {
+			samples[nsamples].name = names[nsamples];
+			samples[nsamples].len = CORPUS_SIZE;
+			samples[nsamples].data = (unsigned char*) malloc(CORPUS_SIZE);
+			if (samples[nsamples].data == NULL)
+				return 1;
+			makers[nsamples](samples[nsamples].data, CORPUS_SIZE);
+		}
+	}
+
+	//a single level when asked for one, otherwise the fast, default and best levels
+	int levels[] = { MIN_LEVEL, DEFAULT_LEVEL, MAX_LEVEL };
+	int nlevels = 3;
+	if (level != 0) {
+		levels[0] = level;
+		nlevels = 1;
+	}
+
+	bool success = true;
+	Rate rates[MAX_RATES];
+	int nrates = 0;
+	for (int l = 0; l < nlevels; l++) {
+		for (int pairs = 0; pairs <= 1; pairs++) {
+			EncodeOptions options;
+			if (pairs && level != 0 && !word_symbols)
+				continue;
+			if (!pairs && level != 0 && word_symbols)
+				continue;
+			initializeOptions(&options, levels[l], pairs);
+			//the sampled levels only code single characters
+			if (pairs && !options.word_symbols)
+				continue;
+
+			double encode_time = 0;
+			double decode_time = 0;
+			size_t total = 0;
+			for (int s = 0; s < nsamples; s++) {
+				success = benchSample(&samples[s], &options, levels[l], runs,
+						&encode_time, &decode_time) && success;
+				total += samples[s].len;
+			}
+
+			//the rates of all of the files, so one fast sample cannot hide a slow one
+			Rate *rate = &rates[nrates++];
+			rate->level = levels[l];
+			rate->word_symbols = options.word_symbols;
+			rate->encode = encode_time > 0 ? total / encode_time / 1e6 : 0;
+			rate->decode = decode_time > 0 ? total / decode_time / 1e6 : 0;
+			if (record != NULL || baseline != NULL)
+				printf("%-24s -%d %-5s %9.1f MB/s enc %9.1f MB/s dec\n", "total",
+						rate->level, rate->word_symbols ? "pairs" : "bytes",
+						rate->encode, rate->decode);
+		}
+	}
+
+	//a missing baseline is recorded, there is nothing to compare with yet
+	if (baseline != NULL) {
+		Rate baseline_rates[MAX_RATES];
+		int nbaseline = readBaseline(baseline, baseline_rates);
+		if (nbaseline < 0) {
+			printf("No baseline in %s yet, recording this run\n", baseline);
+			if (record == NULL)
+				record = baseline;
+		} else {
+			success = compareBaseline(rates, nrates, baseline_rates, nbaseline,
+					tolerance) && success;
+		}
+	}
+
+	//only a run that round tripped everything is worth keeping
+	if (record != NULL && success && !writeBaseline(record, rates, nrates)) {
+		printf("ERROR: Cannot write %s\n", record);
+		success = false;
+	}
+
+	for (int s = 0; s < nsamples; s++)
+		free(samples[s].data);
+	clearTableCache();
+	return success ? 0 : 1;
+}
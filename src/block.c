@@ -0,0 +1,733 @@
+/*
+ -------------------------------------
+ File:    block.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stddef.h>
+#include <limits.h>
+#include <math.h>
+
+#include "tree.h"
+#include "table.h"
+#include "block.h"
+
+//Zeroed bytes after the packed bits, so reading a full window never overruns
+#define BIT_PADDING	8
+
+//Settings of every level, from MIN_LEVEL to MAX_LEVEL
+static const EncodeOptions levels[MAX_LEVEL] = {
+	//block size, byte pairs, sample step, reuse slack, split chunk, code length, queue depth
+	{ 1 << 18, false, 16, 8, 0, SHORT_CODE_LEN, QUEUE_DEPTH },
+	{ 1 << 17, false, 8, 16, 0, SHORT_CODE_LEN, QUEUE_DEPTH },
+	{ 1 << 16, false, 4, 32, 0, SHORT_CODE_LEN, QUEUE_DEPTH },
+	{ 1 << 17, false, 1, 32, 0, MAX_CODE_LEN, QUEUE_DEPTH },
+	{ 1 << 16, false, 1, 64, 0, MAX_CODE_LEN, QUEUE_DEPTH },
+	{ 1 << 16, false, 1, 128, 0, MAX_CODE_LEN, QUEUE_DEPTH },
+	{ 1 << 20, false, 1, 128, 1 << 14, MAX_CODE_LEN, QUEUE_DEPTH },
+	{ 1 << 20, false, 1, 256, 1 << 13, MAX_CODE_LEN, QUEUE_DEPTH },
+	{ 1 << 20, false, 1, 0, 1 << 12, MAX_CODE_LEN, QUEUE_DEPTH }
+};
+
+/* Returns a printable name for a block type */
+const char* blockTypeName(BlockType type) {
+	switch (type) {
+	case BLOCK_RAW:
+		return "RAW";
+	case BLOCK_RLE:
+		return "RLE";
+	case BLOCK_HUFFMAN:
+		return "HUFFMAN";
+	case BLOCK_HUFFMAN16:
+		return "HUFFMAN16";
+	case BLOCK_REPEAT:
+		return "REPEAT";
+	}
+	return "UNKNOWN";
+}
+
+/* Sets the options of a compression level */
+void initializeOptions(EncodeOptions *options, int level, bool word_symbols) {
+	if (level < MIN_LEVEL || level > MAX_LEVEL)
+		level = DEFAULT_LEVEL;
+	*options = levels[level - 1];
+
+	//sampled histograms would have to keep all 65536 byte pairs codable
+	options->word_symbols = word_symbols && options->sample_step == 1;
+	if (options->word_symbols && options->block_size < WORD_BLOCK_SIZE)
+		options->block_size = WORD_BLOCK_SIZE;
+}
+
+/* Returns the largest output of encoding block_size characters, however they are split */
+size_t getEncodedBound(const EncodeOptions *options) {
+	size_t blocks = 1;
+	if (options->split_chunk > 0)
+		blocks = (options->block_size + options->split_chunk - 1)
+				/ options->split_chunk;
+	return options->block_size + blocks * BLOCK_HEADER;
+}
+
+/* Returns the number of symbols present in a frequency table */
+static unsigned int countUnique(const unsigned int *counts, int symbols) {
+	unsigned int unique = 0;
+	for (int i = 0; i < symbols; i++)
+		if (counts[i] > 0)
+			unique++;
+	return unique;
+}
+
+/* Counts the characters of a block, or every step-th one scaled back up. Characters
+ skipped by a sample may still be in the block, so every character is kept codable */
+void countChars(const unsigned char *data, unsigned int len,
+		unsigned int step, unsigned int *counts) {
+	for (unsigned int i = 0; i < len; i += step)
+		counts[data[i]]++;
+
+	if (step > 1)
+		for (int i = 0; i < MAX_CHARS; i++)
+			counts[i] = counts[i] * step + 1;
+}
+
+/* Returns whether a block is a single character repeated */
+static bool isRun(const unsigned char *data, unsigned int len) {
+	for (unsigned int i = 1; i < len; i++)
+		if (data[i] != data[0])
+			return false;
+	return true;
+}
+
+/* Returns the approximate Huffman coded size of a frequency table in bits. Codes take
+ at least a bit, and a single symbol takes none since it is stored as a run */
+static double getCodeCost(const unsigned int *counts) {
+	unsigned long long n = 0;
+	double bits = 0;
+	for (int i = 0; i < MAX_CHARS; i++)
+		n += counts[i];
+	for (int i = 0; i < MAX_CHARS; i++) {
+		if (counts[i] == n)
+			return 0;
+		if (counts[i] > 0)
+			bits += counts[i] * fmax(1, log2((double) n / counts[i]));
+	}
+	return bits;
+}
+
+/* Returns whether coding two frequency tables together costs more than coding the
+ second one as a block of its own, joined is filled with their sum */
+static bool diverges(const unsigned int *counts, double cost,
+		const unsigned int *next, double next_cost, unsigned int *joined) {
+	for (int i = 0; i < MAX_CHARS; i++)
+		joined[i] = counts[i] + next[i];
+
+	//a new block pays for its header, code table and bit length
+	double table_cost = 8.0
+			* (BLOCK_HEADER + 2 * sizeof(unsigned int)
+					+ 2 * countUnique(next, MAX_CHARS));
+	return getCodeCost(joined) > cost + next_cost + table_cost;
+}
+
+/* Returns the length of the next block to encode. The block ends before the first
+ chunk whose histogram diverges enough to pay for a new table, either from the chunk
+ before it, which catches short changes like a run of padding, or from the whole
+ block so far, which catches content drifting slowly */
+unsigned int splitBlock(const unsigned char *data, unsigned int len,
+		const EncodeOptions *options) {
+	unsigned int chunk = options->split_chunk;
+	unsigned int counts[MAX_CHARS] = { 0 };
+	unsigned int last[MAX_CHARS] = { 0 };
+	unsigned int pos = chunk;
+
+	if (chunk == 0 || len <= chunk)
+		return len;
+
+	countChars(data, chunk, 1, last);
+	memcpy(counts, last, sizeof(counts));
+	double cost = getCodeCost(counts);
+	double last_cost = cost;
+
+	while (pos < len) {
+		unsigned int n = len - pos < chunk ? len - pos : chunk;
+		unsigned int next[MAX_CHARS] = { 0 };
+		unsigned int joined[MAX_CHARS];
+
+		countChars(data + pos, n, 1, next);
+		double next_cost = getCodeCost(next);
+		if (diverges(last, last_cost, next, next_cost, joined)
+				|| diverges(counts, cost, next, next_cost, joined))
+			break;
+
+		//joined holds the whole block with the chunk added
+		memcpy(counts, joined, sizeof(counts));
+		cost = getCodeCost(counts);
+		memcpy(last, next, sizeof(last));
+		last_cost = next_cost;
+		pos += n;
+	}
+
+	return pos;
+}
+
+/* Returns the width in bytes of the symbols coded by a table */
+static int tableWidth(const HuffTable *table) {
+	return table->symbols > MAX_CHARS ? 2 : 1;
+}
+
+/* Returns the size of the coded bits of a block, including their header. It is
+ exact for exact counts, and an estimate for sampled ones */
+static unsigned long long codedSize(unsigned long long bits, unsigned int len,
+		int width) {
+	//odd blocks keep their last byte when coding byte pairs
+	return sizeof(unsigned int) + len % width + (bits + 7) / 8;
+}
+
+/* Builds the code lengths of a table from a frequency table, no longer than max_len
+ unless the symbols need more. Returns the number of symbols coded */
+unsigned int buildCodeLengths(HuffTable *table, const unsigned int *counts,
+		int max_len) {
+	unsigned int unique = countUnique(counts, table->symbols);
+
+	//no length limit can be shorter than a balanced code of every symbol
+	while (max_len < MAX_CODE_LEN && (1ULL << max_len) < unique)
+		max_len++;
+	getCodeLengths(counts, table->symbols, table->lens, max_len);
+	return unique;
+}
+
+/* Builds the code lengths for a frequency table, returns the size of the block payload */
+static unsigned long long planHuffmanBlock(HuffTable *table,
+		const unsigned int *counts, unsigned int len, int width, int max_len) {
+	unsigned int unique = buildCodeLengths(table, counts, max_len);
+
+	//each table entry is a symbol and its code length
+	return sizeof(unique) + unique * (width + 1)
+			+ codedSize(getEncodedBits(table, counts), len, width);
+}
+
+/* Returns a bound no new byte table can beat on the payload of a block, the table
+ and the entropy of the counts */
+static unsigned long long getLowerBound(const unsigned int *counts,
+		unsigned int len) {
+	unsigned int unique = countUnique(counts, MAX_CHARS);
+	unsigned long long n = 0;
+	double bits = 0;
+
+	for (int i = 0; i < MAX_CHARS; i++)
+		n += counts[i];
+	for (int i = 0; i < MAX_CHARS; i++)
+		if (counts[i] > 0)
+			bits += counts[i] * log2((double) n / counts[i]);
+
+	//rounded down, so floating point error never lifts it past a real code
+	return sizeof(unique) + unique * 2
+			+ codedSize((unsigned long long) (bits * (1 - 1e-9)), len, 1);
+}
+
+/* Returns the payload size of a block coded with an existing table */
+static unsigned long long planRepeatBlock(const HuffTable *table,
+		const unsigned int *counts, unsigned int len) {
+
+	//the table can only be reused if it has a code for every symbol
+	for (int i = 0; i < table->symbols; i++)
+		if (counts[i] > 0 && table->lens[i] == 0)
+			return ULLONG_MAX;
+
+	return codedSize(getEncodedBits(table, counts), len, tableWidth(table));
+}
+
+/* Returns whether repeating the last table is worth it at the given reuse slack */
+static bool keepsTable(unsigned long long repeat_size, unsigned long long size,
+		unsigned int slack) {
+	if (repeat_size == ULLONG_MAX)
+		return false;
+	return repeat_size <= size + (slack > 0 ? size / slack : 0);
+}
+
+/* Copies n bytes to the output, returns the position after them */
+static unsigned char* putBytes(unsigned char *out, const void *data, size_t n) {
+	memcpy(out, data, n);
+	return out + n;
+}
+
+/* Writes the code length table of a block, returns the position after it */
+static unsigned char* writeCodeTable(const HuffTable *table, unsigned char *out) {
+	int width = tableWidth(table);
+	unsigned int unique = 0;
+
+	for (int i = 0; i < table->symbols; i++)
+		if (table->lens[i] > 0)
+			unique++;
+
+	out = putBytes(out, &unique, sizeof(unique));
+
+	//write the code length table
+	for (int i = 0; i < table->symbols; i++) {
+		if (table->lens[i] > 0) {
+			unsigned char symbol[2] = { (unsigned char) (i >> 8),
+					(unsigned char) i };
+			out = putBytes(out, symbol + 2 - width, width);
+			*out++ = table->lens[i];
+		}
+	}
+
+	return out;
+}
+
+/* Writes the packed Huffman bits of a block, returns the position after them, or
+ NULL when they would run past end */
+static unsigned char* writeCodedBits(const unsigned char *data,
+		unsigned int len, const HuffTable *table, unsigned char *out,
+		const unsigned char *end) {
+	int width = tableWidth(table);
+	unsigned char *bit_len_pos = out;
+	unsigned long long bits = 0;
+
+	//the bit length is only known once everything is packed
+	if (end - out <= (ptrdiff_t) sizeof(unsigned int))
+		return NULL;
+	out += sizeof(unsigned int);
+
+	//a trailing byte that does not make up a full pair is stored as is
+	if (len % width != 0)
+		*out++ = data[len - 1];
+
+	//pack the codes most significant bit first, 32 bits at a time, codes are
+	//at most 24 bits so the accumulator never holds more than 55
+	unsigned long long acc = 0;
+	int acc_bits = 0;
+	unsigned int i = 0;
+
+	//short byte codes go in two at a time, at most 32 bits on top of 31
+	if (width == 1 && table->max_len <= 16) {
+		const HuffCode *codes = table->codes;
+		for (; i + 2 <= len; i += 2) {
+			const HuffCode *a = &codes[data[i]];
+			const HuffCode *b = &codes[data[i + 1]];
+			acc = (((acc << a->len) | a->bits) << b->len) | b->bits;
+			acc_bits += a->len + b->len;
+			bits += a->len + b->len;
+			if (acc_bits >= 32) {
+				if (end - out < 4)
+					return NULL;
+				acc_bits -= 32;
+				unsigned int word = (unsigned int) (acc >> acc_bits);
+				out[0] = (unsigned char) (word >> 24);
+				out[1] = (unsigned char) (word >> 16);
+				out[2] = (unsigned char) (word >> 8);
+				out[3] = (unsigned char) word;
+				out += 4;
+			}
+		}
+	}
+
+	for (; i + width <= len; i += width) {
+		int symbol = width == 2 ? (data[i] << 8) | data[i + 1] : data[i];
+		const HuffCode *code = &table->codes[symbol];
+		acc = (acc << code->len) | code->bits;
+		acc_bits += code->len;
+		bits += code->len;
+		if (acc_bits >= 32) {
+			if (end - out < 4)
+				return NULL;
+			acc_bits -= 32;
+			unsigned int word = (unsigned int) (acc >> acc_bits);
+			out[0] = (unsigned char) (word >> 24);
+			out[1] = (unsigned char) (word >> 16);
+			out[2] = (unsigned char) (word >> 8);
+			out[3] = (unsigned char) word;
+			out += 4;
+		}
+	}
+
+	//write any leftover bits
+	for (; acc_bits > 0; acc_bits -= 8) {
+		if (out == end)
+			return NULL;
+		*out++ = (unsigned char) (acc_bits >= 8 ?
+				acc >> (acc_bits - 8) : acc << (8 - acc_bits));
+	}
+
+	unsigned int bit_len = (unsigned int) bits;
+	memcpy(bit_len_pos, &bit_len, sizeof(bit_len));
+	return out;
+}
+
+/* Makes the given table the one later blocks may repeat, taking over its reference */
+static void keepTable(BlockState *state, HuffTable *table) {
+	freeTable(state->table);
+	state->table = table;
+}
+
+/* Releases the table kept between blocks */
+void freeBlockState(BlockState *state) {
+	freeTable(state->table);
+	state->table = NULL;
+}
+
+/* Writes the header of a block, returns the position after it */
+static unsigned char* writeBlockHeader(unsigned char *out, BlockType type,
+		unsigned int len) {
+	*out++ = (unsigned char) type;
+	return putBytes(out, &len, sizeof(len));
+}
+
+/* Encodes a single block of input into out, which holds at least MAX_ENCODED_SIZE(len) bytes */
+bool encodeBlock(const unsigned char *data, unsigned int len,
+		unsigned char *out, size_t *size_out, const EncodeOptions *options,
+		BlockState *state, BlockType *type) {
+	unsigned char *start = out;
+	unsigned char *end = start + MAX_ENCODED_SIZE(len);
+	unsigned int counts[MAX_CHARS] = { 0 };
+	unsigned int *pair_counts = NULL;
+	HuffTable *table = NULL;
+	HuffTable *pair_table = NULL;
+	HuffTable *coded = NULL;
+	HuffTable *fresh = NULL;
+	unsigned long long size = len;
+
+	//a single symbol has an empty Huffman code, store it as a run instead
+	if (isRun(data, len)) {
+		*type = BLOCK_RLE;
+	} else {
+		//size of the encoded block, known before encoding anything
+		countChars(data, len, options->sample_step, counts);
+		*type = BLOCK_HUFFMAN;
+
+		//a repeat within slack of the best any new byte table could do is kept
+		//without building one, planning it would make the same choice
+		if (!options->word_symbols && state->table != NULL
+				&& tableWidth(state->table) == 1) {
+			unsigned long long repeat_size = planRepeatBlock(state->table,
+					counts, len);
+			if (keepsTable(repeat_size, getLowerBound(counts, len),
+					options->reuse_slack)) {
+				*type = BLOCK_REPEAT;
+				size = repeat_size;
+				coded = state->table;
+			}
+		}
+
+		if (*type != BLOCK_REPEAT) {
+			if ((table = createTable(MAX_CHARS)) == NULL)
+				return false;
+			size = planHuffmanBlock(table, counts, len, 1,
+					options->max_code_len);
+			coded = table;
+
+			//byte pairs win when the extra table is paid back by shorter codes
+			if (options->word_symbols && len >= 2) {
+				pair_counts = (unsigned int*) calloc(MAX_WORDS,
+						sizeof(unsigned int));
+				pair_table = createTable(MAX_WORDS);
+				if (pair_counts == NULL || pair_table == NULL) {
+					free(pair_counts);
+					freeTable(pair_table);
+					freeTable(table);
+					return false;
+				}
+
+				for (unsigned int i = 0; i + 1 < len; i += 2)
+					pair_counts[(data[i] << 8) | data[i + 1]]++;
+
+				if (countUnique(pair_counts, MAX_WORDS) > 1) {
+					unsigned long long pair_size = planHuffmanBlock(pair_table,
+							pair_counts, len, 2, options->max_code_len);
+					if (pair_size < size) {
+						*type = BLOCK_HUFFMAN16;
+						size = pair_size;
+						coded = pair_table;
+					}
+				}
+			}
+
+			//reuse the previous table when it costs about as much as a new one,
+			//which saves the table in the output and building it when decoding
+			if (state->table != NULL) {
+				const unsigned int *c =
+						tableWidth(state->table) == 2 ? pair_counts : counts;
+				unsigned long long repeat_size = c != NULL ?
+						planRepeatBlock(state->table, c, len) : ULLONG_MAX;
+				if (keepsTable(repeat_size, size, options->reuse_slack)) {
+					*type = BLOCK_REPEAT;
+					size = repeat_size;
+					coded = state->table;
+				}
+			}
+			free(pair_counts);
+		}
+
+		//incompressible data would only expand, store it raw instead
+		if (size >= len)
+			*type = BLOCK_RAW;
+	}
+
+	//new tables come from the shared cache, which builds them if they are not in it
+	if (*type == BLOCK_HUFFMAN || *type == BLOCK_HUFFMAN16) {
+		if (coded == table)
+			table = NULL;
+		else
+			pair_table = NULL;
+		if ((coded = fresh = shareTable(coded)) == NULL)
+			*type = BLOCK_RAW;
+	}
+
+	out = writeBlockHeader(out, *type, len);
+
+	switch (*type) {
+	case BLOCK_RLE:
+		*out++ = data[0];
+		break;
+	case BLOCK_RAW:
+		out = putBytes(out, data, len);
+		break;
+	case BLOCK_HUFFMAN:
+	case BLOCK_HUFFMAN16:
+		out = writeCodeTable(coded, out);
+		if (out != NULL)
+			out = writeCodedBits(data, len, coded, out, end);
+		break;
+	case BLOCK_REPEAT:
+		out = writeCodedBits(data, len, coded, out, end);
+		break;
+	}
+
+	//sampled counts can underestimate the coded size, such blocks are stored raw
+	if (out == NULL) {
+		*type = BLOCK_RAW;
+		out = writeBlockHeader(start, *type, len);
+		out = putBytes(out, data, len);
+		freeTable(fresh);
+	} else if (fresh != NULL) {
+		keepTable(state, fresh);
+	}
+
+	freeTable(table);
+	freeTable(pair_table);
+
+	*size_out = out - start;
+	return true;
+}
+
+/* Returns the next 64 bits of the stream starting at the given bit position */
+static unsigned long long peekBits(const unsigned char *packed, size_t pos) {
+	const unsigned char *p = packed + (pos >> 3);
+	unsigned long long window = 0;
+	for (int i = 0; i < 8; i++)
+		window = (window << 8) | p[i];
+	return window << (pos & 7);
+}
+
+/* Decodes a code longer than the lookup table one length at a time */
+static int decodeLongCode(const HuffTable *table, unsigned long long window,
+		int *len) {
+	for (int l = table->lookup_bits + 1; l <= MAX_CODE_LEN; l++) {
+		unsigned int code = (unsigned int) (window >> (64 - l));
+		if (code - table->first[l] < table->count[l]) {
+			*len = l;
+			return table->sorted[table->offset[l] + code - table->first[l]];
+		}
+	}
+	//unreachable for a complete code
+	*len = MAX_CODE_LEN;
+	return 0;
+}
+
+/* Reads the code length table of a Huffman block and builds its decode table */
+static HuffTable* readCodeTable(FILE *iFile, int width) {
+	unsigned int unique = 0;
+
+	if (fread(&unique, sizeof(unique), 1, iFile) != 1 || unique < 2
+			|| unique > (width == 2 ? MAX_WORDS : MAX_CHARS))
+		return NULL;
+
+	HuffTable *table = createTable(width == 2 ? MAX_WORDS : MAX_CHARS);
+	if (table == NULL)
+		return NULL;
+
+	for (unsigned int i = 0; i < unique; i++) {
+		unsigned char symbol[2] = { 0 };
+		unsigned char code_len = 0;
+		if (fread(symbol + 2 - width, 1, width, iFile) != (size_t) width
+				|| fread(&code_len, sizeof(code_len), 1, iFile) != 1) {
+			freeTable(table);
+			return NULL;
+		}
+
+		int s = (symbol[0] << 8) | symbol[1];
+		if (code_len == 0 || table->lens[s] != 0) {
+			freeTable(table);
+			return NULL;
+		}
+		table->lens[s] = code_len;
+	}
+
+	//rejects code lengths that are too long or do not form a complete code
+	return shareTable(table);
+}
+
+/* Decodes one code from the top of the window, returns its symbol */
+static inline int decodeCode(const HuffTable *table, unsigned long long window,
+		int *code_len) {
+	DecodeEntry entry = table->lookup[window >> (64 - table->lookup_bits)];
+	*code_len = entry.len;
+	if (entry.len == 0)
+		return decodeLongCode(table, window, code_len);
+	return entry.symbol;
+}
+
+/* Decodes nsym symbols from the packed bits into out */
+static bool decodeSymbols(const HuffTable *table, const unsigned char *packed,
+		unsigned int bit_len, unsigned int nsym, int width, unsigned char *out) {
+	size_t pos = 0;
+	unsigned int n = 0;
+	int code_len = 0;
+
+	//short codes all resolve in one lookup, a window holds as many as fit in 57 bits
+	if (table->max_len <= table->lookup_bits) {
+		int max_len = table->max_len > 0 ? table->max_len : 1;
+		unsigned int per_window = 57 / max_len;
+		int shift = 64 - table->lookup_bits;
+
+		while (n + per_window <= nsym
+				&& pos + per_window * max_len <= bit_len) {
+			unsigned long long window = peekBits(packed, pos);
+			for (unsigned int k = 0; k < per_window; k++, n++) {
+				DecodeEntry entry = table->lookup[window >> shift];
+				window <<= entry.len;
+				pos += entry.len;
+				if (width == 2) {
+					out[2 * n] = (unsigned char) (entry.symbol >> 8);
+					out[2 * n + 1] = (unsigned char) entry.symbol;
+				} else
+					out[n] = (unsigned char) entry.symbol;
+			}
+		}
+	}
+
+	//fast loop, a window holds at least 57 bits so two codes of any length fit,
+	//and neither can run past the end of the bits while this much is left
+	while (n + 2 <= nsym && pos + 2 * MAX_CODE_LEN <= bit_len) {
+		unsigned long long window = peekBits(packed, pos);
+		for (int k = 0; k < 2; k++, n++) {
+			int symbol = decodeCode(table, window, &code_len);
+			window <<= code_len;
+			pos += code_len;
+			if (width == 2) {
+				out[2 * n] = (unsigned char) (symbol >> 8);
+				out[2 * n + 1] = (unsigned char) symbol;
+			} else
+				out[n] = (unsigned char) symbol;
+		}
+	}
+
+	//tail loop, checks every code against the end of the bits
+	for (; n < nsym; n++) {
+		int symbol = decodeCode(table, peekBits(packed, pos), &code_len);
+		pos += code_len;
+		if (pos > bit_len)
+			return false;
+		if (width == 2) {
+			out[2 * n] = (unsigned char) (symbol >> 8);
+			out[2 * n + 1] = (unsigned char) symbol;
+		} else
+			out[n] = (unsigned char) symbol;
+	}
+
+	return pos == bit_len;
+}
+
+/* Reads the packed Huffman bits of a block and decodes them into out */
+static bool readCodedBits(FILE *iFile, unsigned char *out, unsigned int len,
+		const HuffTable *table) {
+	int width = tableWidth(table);
+	unsigned char *packed = NULL;
+	unsigned int bit_len = 0;
+	unsigned int nsym = len / width;
+	bool success = false;
+
+	//every symbol takes between 1 and MAX_CODE_LEN bits
+	if (fread(&bit_len, sizeof(bit_len), 1, iFile) != 1 || bit_len < nsym
+			|| (unsigned long long) bit_len
+					> (unsigned long long) nsym * MAX_CODE_LEN)
+		return false;
+
+	//the odd character of a byte pair block comes before the bits
+	if (len % width != 0 && fread(out + len - 1, 1, 1, iFile) != 1)
+		return false;
+
+	size_t nbytes = ((size_t) bit_len + 7) / 8;
+	if ((packed = (unsigned char*) malloc(nbytes + BIT_PADDING)) != NULL
+			&& fread(packed, 1, nbytes, iFile) == nbytes) {
+		memset(packed + nbytes, 0, BIT_PADDING);
+		success = decodeSymbols(table, packed, bit_len, nsym, width, out);
+	}
+
+	free(packed);
+	return success;
+}
+
+/* Reads the table of a Huffman block so the blocks appended after it can repeat it */
+bool readBlockTable(FILE *iFile, BlockState *state) {
+	unsigned char t = 0;
+	unsigned int len = 0;
+	HuffTable *table = NULL;
+
+	if (fread(&t, sizeof(t), 1, iFile) != 1
+			|| fread(&len, sizeof(len), 1, iFile) != 1
+			|| (t != BLOCK_HUFFMAN && t != BLOCK_HUFFMAN16))
+		return false;
+
+	if ((table = readCodeTable(iFile, t == BLOCK_HUFFMAN16 ? 2 : 1)) == NULL)
+		return false;
+
+	keepTable(state, table);
+	return true;
+}
+
+/* Decodes a single block from file into out, which holds capacity bytes. Fails
+ without writing anything when the block is longer than that */
+bool decodeBlock(FILE *iFile, unsigned char *out, unsigned int capacity,
+		BlockState *state, unsigned int *len, BlockType *type) {
+	unsigned char t = 0;
+	HuffTable *table = NULL;
+
+	if (fread(&t, sizeof(t), 1, iFile) != 1
+			|| fread(len, sizeof(*len), 1, iFile) != 1)
+		return false;
+
+	if (*len < 1 || *len > MAX_BLOCK_SIZE || *len > capacity)
+		return false;
+
+	*type = (BlockType) t;
+	switch (*type) {
+	case BLOCK_RLE:
+		//the whole block is one repeated symbol
+		if (fread(&t, sizeof(t), 1, iFile) != 1)
+			return false;
+		memset(out, t, *len);
+		return true;
+	case BLOCK_RAW:
+		//the block is stored as is, copy it straight through
+		return fread(out, 1, *len, iFile) == *len;
+	case BLOCK_HUFFMAN:
+	case BLOCK_HUFFMAN16:
+		table = readCodeTable(iFile, *type == BLOCK_HUFFMAN16 ? 2 : 1);
+		if (table == NULL)
+			return false;
+		keepTable(state, table);
+		return readCodedBits(iFile, out, *len, table);
+	case BLOCK_REPEAT:
+		//coded with the table of the last Huffman block
+		return state->table != NULL
+				&& readCodedBits(iFile, out, *len, state->table);
+	default:
+		return false;
+	}
+}
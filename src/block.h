@@ -0,0 +1,75 @@
+/*
+ -------------------------------------
+ File:    block.h
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#ifndef BLOCK_H_
+#define BLOCK_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "table.h"
+
+#define MAX_CHARS	256
+#define MAX_WORDS	65536	//16-bit symbols, made of byte pairs
+#define BLOCK_SIZE	(1 << 16)	//bytes of input encoded per block
+#define WORD_BLOCK_SIZE	(1 << 18)	//larger blocks amortise the bigger 16-bit tables
+#define MAX_BLOCK_SIZE	(1 << 24)	//largest block the decoder will accept
+#define BLOCK_HEADER	(sizeof(unsigned char) + sizeof(unsigned int))	//block type and length
+#define MIN_LEVEL	1	//fastest, from sampled histograms
+#define MAX_LEVEL	9	//best ratio, from blocks split where the histogram shifts
+#define DEFAULT_LEVEL	5
+#define QUEUE_DEPTH	8	//most blocks kept in flight in each direction by asynchronous I/O
+
+//Largest encoded block, anything that would not shrink is stored raw
+#define MAX_ENCODED_SIZE(len)	((size_t) (len) + BLOCK_HEADER)
+
+typedef enum BlockType {
+	BLOCK_RAW = 0,		//stored as is
+	BLOCK_RLE = 1,		//a single symbol repeated for the whole block
+	BLOCK_HUFFMAN = 2,	//code lengths followed by the Huffman encoded bits
+	BLOCK_HUFFMAN16 = 3,	//same as BLOCK_HUFFMAN, with byte pairs as symbols
+	BLOCK_REPEAT = 4	//Huffman encoded bits using the table of the last Huffman block
+} BlockType;
+
+typedef struct EncodeOptions {
+	unsigned int block_size;	//input encoded at a time, split further when split_chunk is set
+	bool word_symbols;	//also try byte pair symbols on every block
+	unsigned int sample_step;	//histograms count every nth character, 1 counts them all
+	unsigned int reuse_slack;	//the last table is repeated while it costs at most 1/reuse_slack
+								//more than a new one, 0 repeats it only when it costs less
+	unsigned int split_chunk;	//blocks end on chunks of this size where the histogram shifts,
+								//0 keeps them whole
+	unsigned int max_code_len;	//longest code, SHORT_CODE_LEN packs and decodes several at a time
+	unsigned int queue_depth;	//blocks read and written ahead with asynchronous I/O, up to
+								//QUEUE_DEPTH, 1 keeps I/O blocking
+} EncodeOptions;
+
+typedef struct BlockState {
+	HuffTable *table;	//table of the last HUFFMAN or HUFFMAN16 block
+} BlockState;
+
+void initializeOptions(EncodeOptions *options, int level, bool word_symbols);
+size_t getEncodedBound(const EncodeOptions *options);
+void countChars(const unsigned char *data, unsigned int len,
+		unsigned int step, unsigned int *counts);
+unsigned int buildCodeLengths(HuffTable *table, const unsigned int *counts,
+		int max_len);
+unsigned int splitBlock(const unsigned char *data, unsigned int len,
+		const EncodeOptions *options);
+bool encodeBlock(const unsigned char *data, unsigned int len,
+		unsigned char *out, size_t *size_out, const EncodeOptions *options,
+		BlockState *state, BlockType *type);
+bool decodeBlock(FILE *iFile, unsigned char *out, unsigned int capacity,
+		BlockState *state, unsigned int *len, BlockType *type);
+bool readBlockTable(FILE *iFile, BlockState *state);
+void freeBlockState(BlockState *state);
+const char* blockTypeName(BlockType type);
+
+#endif /* BLOCK_H_ */
@@ -0,0 +1,175 @@
+/*
+ -------------------------------------
+ File:    budget.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "tree.h"
+#include "pQueue.h"
+#include "table.h"
+#include "block.h"
+#include "container.h"
+#include "budget.h"
+
+/* Returns the memory the block index takes for a number of blocks, its capacity
+ doubles as it grows */
+static size_t getIndexBytes(unsigned long long blocks) {
+	unsigned long long capacity = 64;
+	while (capacity < blocks)
+		capacity *= 2;
+	return capacity * sizeof(BlockEntry);
+}
+
+/* Returns the most memory building the code lengths of up to symbols symbols takes:
+ every leaf and merged node of the tree with its queue entry, each allocated on its
+ own, then the sorted leaves and their counts */
+static size_t getTreeBytes(unsigned long long symbols) {
+	if (symbols == 0)
+		return 0;
+	return (2 * symbols - 1)
+			* (sizeof(TNode) + sizeof(QNode) + 2 * ALLOC_OVERHEAD)
+			+ symbols * (sizeof(TNode*) + sizeof(unsigned int));
+}
+
+/* Returns the most symbols a tree is built from, for counts of len characters */
+static unsigned long long getTreeSymbols(bool word_symbols,
+		unsigned long long len) {
+	unsigned long long symbols = word_symbols ? MAX_WORDS : MAX_CHARS;
+	unsigned long long counted = word_symbols ? len / 2 : len;
+	return counted < symbols ? counted : symbols;
+}
+
+/* Gives the shared table cache its part of a memory limit, returns the part left.
+ The cache is shared by the whole process, so this limits every later file too */
+size_t limitTableCache(size_t limit) {
+	size_t cache = limit / TABLE_CACHE_SHARE;
+	if (cache > TABLE_CACHE_BYTES)
+		cache = TABLE_CACHE_BYTES;
+	setTableCacheBytes(cache);
+	return limit - cache;
+}
+
+/* Returns the most memory encoding input_len characters takes besides the table cache:
+ the blocks in flight and their encoded output, the tables, counts and tree of the
+ block being encoded, the block index and the stdio buffers of both files. It is never
+ less than verifying the output takes, so what is encoded within a limit can be
+ decoded and verified within it */
+size_t getEncodeMemory(const EncodeOptions *options,
+		unsigned long long input_len) {
+	size_t depth = options->queue_depth > 1 ? options->queue_depth : 1;
+	size_t memory = depth * (options->block_size + getEncodedBound(options));
+
+	//a decoded block, its part of the original and its packed bits
+	size_t verify = 3 * (options->block_size + sizeof(unsigned long long));
+	if (memory < verify)
+		memory = verify;
+
+	//the last table, a new one and the byte table it competes with
+	memory += getTableBytes(MAX_CHARS);
+	if (options->word_symbols)
+		memory += 2 * getTableBytes(MAX_WORDS)
+				+ MAX_WORDS * sizeof(unsigned int);
+	else
+		memory += 2 * getTableBytes(MAX_CHARS);
+
+	//one tree at a time, the byte pairs one is the larger
+	memory += getTreeBytes(
+			getTreeSymbols(options->word_symbols, options->block_size));
+
+	//every read may be split into chunks of its own
+	unsigned long long blocks = (input_len + options->block_size - 1)
+			/ options->block_size;
+	if (options->split_chunk > 0)
+		blocks *= (options->block_size + options->split_chunk - 1)
+				/ options->split_chunk;
+
+	return memory + getIndexBytes(blocks) + 2 * BUFSIZ;
+}
+
+/* Returns the most memory estimating input_len characters takes: the block being
+ counted, the counts, the table and tree built from them, all of the input counted
+ into one, and the stdio buffer of the input */
+size_t getEstimateMemory(const EncodeOptions *options,
+		unsigned long long input_len) {
+	int symbols = options->word_symbols ? MAX_WORDS : MAX_CHARS;
+	size_t memory = options->block_size + getTableBytes(symbols)
+			+ getTreeBytes(getTreeSymbols(options->word_symbols, input_len));
+
+	if (options->word_symbols)
+		memory += MAX_WORDS * sizeof(unsigned int);
+	return memory + BUFSIZ;
+}
+
+/* Returns the most memory decoding a file takes besides the table cache, with buffers
+ blocks held in memory at a time: those blocks, the packed bits of the block being
+ decoded, its table and the last one, the block index and the stdio buffers */
+size_t getDecodeMemory(const BlockIndex *index, unsigned int buffers) {
+	size_t max_len = getMaxBlockLen(index);
+	int symbols = MAX_CHARS;
+
+	for (unsigned int i = 0; i < index->count; i++)
+		if (index->entries[i].type == BLOCK_HUFFMAN16)
+			symbols = MAX_WORDS;
+
+	return (buffers + 1) * (max_len + sizeof(unsigned long long))
+			+ 2 * getTableBytes(symbols) + getIndexBytes(index->count)
+			+ 2 * BUFSIZ;
+}
+
+/* Fits encoding input_len characters in limit bytes, table cache included. Gives up
+ blocks in flight first, then block size down to the default, then asynchronous I/O,
+ then byte pairs, then splitting, whose index has room for a block per chunk, and
+ finally block size down to MIN_BLOCK_SIZE. Returns false when even that does not fit */
+bool limitMemory(EncodeOptions *options, size_t limit,
+		unsigned long long input_len) {
+	size_t budget = limitTableCache(limit);
+
+	while (getEncodeMemory(options, input_len) > budget) {
+		unsigned int floor =
+				options->word_symbols ? WORD_BLOCK_SIZE : BLOCK_SIZE;
+
+		if (options->queue_depth > 2) {
+			options->queue_depth /= 2;
+		} else if (options->block_size > floor) {
+			options->block_size /= 2;
+		} else if (options->queue_depth > 1) {
+			options->queue_depth = 1;
+		} else if (options->word_symbols) {
+			options->word_symbols = false;
+		} else if (options->split_chunk > 0) {
+			options->split_chunk = 0;
+		} else if (options->block_size > MIN_BLOCK_SIZE) {
+			options->block_size /= 2;
+		} else {
+			return false;
+		}
+
+		//blocks no larger than a chunk have nothing left to split
+		if (options->split_chunk >= options->block_size)
+			options->split_chunk = 0;
+	}
+
+	return true;
+}
+
+/* Fits estimating input_len characters in limit bytes, so the estimate is of what
+ encoding within the limit writes. The counts of the whole input can need a larger
+ tree than those of a block, byte pairs are dropped when it does not fit */
+bool limitEstimateMemory(EncodeOptions *options, size_t limit,
+		unsigned long long input_len) {
+	if (!limitMemory(options, limit, input_len))
+		return false;
+
+	size_t budget = limitTableCache(limit);
+	if (getEstimateMemory(options, input_len) > budget)
+		options->word_symbols = false;
+	return getEstimateMemory(options, input_len) <= budget;
+}
@@ -0,0 +1,35 @@
+/*
+ -------------------------------------
+ File:    budget.h
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#ifndef BUDGET_H_
+#define BUDGET_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "block.h"
+#include "container.h"
+
+#define MIN_BLOCK_SIZE	(1 << 12)	//smallest block a memory limit shrinks blocks to
+#define TABLE_CACHE_SHARE	4	//the table cache gets at most 1/TABLE_CACHE_SHARE of a limit
+#define ALLOC_OVERHEAD	16	//most bytes the allocator adds to a small allocation
+
+size_t limitTableCache(size_t limit);
+size_t getEncodeMemory(const EncodeOptions *options,
+		unsigned long long input_len);
+size_t getEstimateMemory(const EncodeOptions *options,
+		unsigned long long input_len);
+size_t getDecodeMemory(const BlockIndex *index, unsigned int buffers);
+bool limitMemory(EncodeOptions *options, size_t limit,
+		unsigned long long input_len);
+bool limitEstimateMemory(EncodeOptions *options, size_t limit,
+		unsigned long long input_len);
+
+#endif /* BUDGET_H_ */
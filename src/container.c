@@ -0,0 +1,175 @@
+/*
+ -------------------------------------
+ File:    container.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "block.h"
+#include "container.h"
+
+/* Creates an empty block index */
+void initializeIndex(BlockIndex *index) {
+	index->entries = NULL;
+	index->count = 0;
+	index->capacity = 0;
+	index->total = 0;
+	index->end = MAGIC_SIZE;
+}
+
+/* Records a block that was just written at the given offset */
+bool addBlockEntry(BlockIndex *index, unsigned long long offset,
+		unsigned int len, unsigned char type) {
+	if (index->count == index->capacity) {
+		unsigned int capacity = index->capacity > 0 ? index->capacity * 2 : 64;
+		BlockEntry *entries = (BlockEntry*) realloc(index->entries,
+				capacity * sizeof(BlockEntry));
+		if (entries == NULL)
+			return false;
+		index->entries = entries;
+		index->capacity = capacity;
+	}
+
+	index->entries[index->count].offset = offset;
+	index->entries[index->count].len = len;
+	index->entries[index->count].type = type;
+	index->count++;
+	index->total += len;
+
+	return true;
+}
+
+/* Writes the block index and the footer at the current position of the file */
+bool writeIndex(FILE *file, BlockIndex *index) {
+	index->end = ftell(file);
+
+	for (unsigned int i = 0; i < index->count; i++) {
+		fwrite(&index->entries[i].offset, 1, sizeof(unsigned long long), file);
+		fwrite(&index->entries[i].len, 1, sizeof(unsigned int), file);
+		fwrite(&index->entries[i].type, 1, sizeof(unsigned char), file);
+	}
+
+	// write footer - index offset, block count, total char count and magic
+	fwrite(&index->end, 1, sizeof(index->end), file);
+	fwrite(&index->count, 1, sizeof(index->count), file);
+	fwrite(&index->total, 1, sizeof(index->total), file);
+	fwrite(FILE_MAGIC, 1, MAGIC_SIZE, file);
+
+	return ferror(file) == 0;
+}
+
+/* Reads and validates the footer and block index of a compressed file */
+bool readIndex(FILE *file, BlockIndex *index) {
+	char magic[MAGIC_SIZE] = { 0 };
+	unsigned int count = 0;
+	unsigned long long total = 0;
+
+	initializeIndex(index);
+
+	// check the header magic, then parse the footer at the end of the file
+	if (fseek(file, 0, SEEK_SET) != 0
+			|| fread(magic, 1, MAGIC_SIZE, file) != MAGIC_SIZE
+			|| memcmp(magic, FILE_MAGIC, MAGIC_SIZE) != 0)
+		return false;
+
+	if (fseek(file, 0, SEEK_END) != 0)
+		return false;
+	long size = ftell(file);
+	if (size < (long) (MAGIC_SIZE + FOOTER_SIZE)
+			|| fseek(file, size - FOOTER_SIZE, SEEK_SET) != 0)
+		return false;
+
+	if (fread(&index->end, sizeof(index->end), 1, file) != 1
+			|| fread(&count, sizeof(count), 1, file) != 1
+			|| fread(&total, sizeof(total), 1, file) != 1
+			|| fread(magic, 1, MAGIC_SIZE, file) != MAGIC_SIZE
+			|| memcmp(magic, FILE_MAGIC, MAGIC_SIZE) != 0)
+		return false;
+
+	//the index has to fill the space between the last block and the footer
+	if (index->end < MAGIC_SIZE
+			|| (unsigned long long) size - FOOTER_SIZE < index->end
+			|| ((unsigned long long) size - FOOTER_SIZE - index->end)
+					!= (unsigned long long) count * ENTRY_SIZE
+			|| fseek(file, index->end, SEEK_SET) != 0)
+		return false;
+
+	unsigned long long end = index->end;
+	unsigned long long next = MAGIC_SIZE;
+	for (unsigned int i = 0; i < count; i++) {
+		BlockEntry entry;
+		if (fread(&entry.offset, sizeof(entry.offset), 1, file) != 1
+				|| fread(&entry.len, sizeof(entry.len), 1, file) != 1
+				|| fread(&entry.type, sizeof(entry.type), 1, file) != 1)
+			break;
+
+		//blocks are stored back to back in index order
+		if (entry.offset < next || entry.offset >= end || entry.len < 1
+				|| entry.len > MAX_BLOCK_SIZE
+				|| !addBlockEntry(index, entry.offset, entry.len, entry.type))
+			break;
+		next = entry.offset + 1;
+	}
+	index->end = end;
+
+	if (index->count != count || index->total != total) {
+		freeIndex(index);
+		return false;
+	}
+
+	return true;
+}
+
+/* Releases a block index */
+void freeIndex(BlockIndex *index) {
+	free(index->entries);
+	initializeIndex(index);
+}
+
+/* Returns the length of the longest block in the index */
+unsigned int getMaxBlockLen(const BlockIndex *index) {
+	unsigned int max_len = 0;
+	for (unsigned int i = 0; i < index->count; i++)
+		if (index->entries[i].len > max_len)
+			max_len = index->entries[i].len;
+	return max_len;
+}
+
+/* Decodes the next block of the file into out, it has to match entry i of the index */
+bool decodeEntry(FILE *file, const BlockIndex *index, unsigned int i,
+		unsigned char *out, BlockState *state) {
+	const BlockEntry *entry = &index->entries[i];
+	unsigned int len = 0;
+	BlockType type;
+
+	return (unsigned long long) ftell(file) == entry->offset
+			&& decodeBlock(file, out, entry->len, state, &len, &type)
+			&& len == entry->len && type == entry->type;
+}
+
+/* Decodes every block of the file back to back into out, which holds capacity bytes */
+bool decodeBlocks(FILE *file, const BlockIndex *index, unsigned char *out,
+		size_t capacity) {
+	BlockState state = { NULL };
+	bool success = index->total <= capacity
+			&& fseek(file, MAGIC_SIZE, SEEK_SET) == 0;
+
+	for (unsigned int i = 0; success && i < index->count; i++) {
+		success = decodeEntry(file, index, i, out, &state);
+		out += index->entries[i].len;
+	}
+
+	//the last block has to end where the index starts
+	success = success && (unsigned long long) ftell(file) == index->end;
+
+	freeBlockState(&state);
+	return success;
+}
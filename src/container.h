@@ -0,0 +1,52 @@
+/*
+ -------------------------------------
+ File:    container.h
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#ifndef CONTAINER_H_
+#define CONTAINER_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "block.h"
+
+#define FILE_MAGIC	"HUF1"
+#define MAGIC_SIZE	4
+//offset, length and type of a block
+#define ENTRY_SIZE	(sizeof(unsigned long long) + sizeof(unsigned int) + 1)
+//index offset, block count, total chars and magic
+#define FOOTER_SIZE	(2 * sizeof(unsigned long long) + sizeof(unsigned int) + MAGIC_SIZE)
+
+typedef struct BlockEntry {
+	unsigned long long offset;
+	unsigned int len;
+	unsigned char type;
+} BlockEntry;
+
+typedef struct BlockIndex {
+	BlockEntry *entries;
+	unsigned int count;
+	unsigned int capacity;
+	unsigned long long total;	//characters in all blocks
+	unsigned long long end;		//offset of the index, just past the last block
+} BlockIndex;
+
+void initializeIndex(BlockIndex *index);
+bool addBlockEntry(BlockIndex *index, unsigned long long offset,
+		unsigned int len, unsigned char type);
+bool writeIndex(FILE *file, BlockIndex *index);
+bool readIndex(FILE *file, BlockIndex *index);
+void freeIndex(BlockIndex *index);
+unsigned int getMaxBlockLen(const BlockIndex *index);
+bool decodeEntry(FILE *file, const BlockIndex *index, unsigned int i,
+		unsigned char *out, BlockState *state);
+bool decodeBlocks(FILE *file, const BlockIndex *index, unsigned char *out,
+		size_t capacity);
+
+#endif /* CONTAINER_H_ */
@@ -0,0 +1,188 @@
+/*
+ -------------------------------------
+ File:    estimate.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+#include "tree.h"
+#include "table.h"
+#include "block.h"
+#include "container.h"
+#include "estimate.h"
+
+/* Returns the Shannon entropy of the counted symbols, in bits per symbol */
+static double getEntropy(const unsigned int *counts, int symbols) {
+	unsigned long long n = 0;
+	double entropy = 0;
+	for (int i = 0; i < symbols; i++)
+		n += counts[i];
+	for (int i = 0; i < symbols; i++)
+		if (counts[i] > 0)
+			entropy += counts[i] * log2((double) n / counts[i]);
+	return n > 0 ? entropy / n : 0;
+}
+
+/* Returns the size of the coded characters and their table, scaled up from the
+ counted symbols to the whole input. The codes are built from code_counts, which
+ are the counts themselves unless the level samples them. Every block after the
+ first is assumed to repeat the table, which is what the encoder does on uniform
+ input */
+static unsigned long long getHuffmanSize(const unsigned int *counts,
+		const unsigned int *code_counts, int symbols, int width, int max_len,
+		double scale, unsigned long long blocks, unsigned long long total) {
+	unsigned long long unique = 0;
+	unsigned long long size = 0;
+
+	for (int i = 0; i < symbols; i++)
+		if (counts[i] > 0)
+			unique++;
+	if (unique < 2)
+		return ULLONG_MAX;
+
+	HuffTable *table = createTable(symbols);
+	if (table == NULL)
+		return ULLONG_MAX;
+
+	//the same code lengths the encoder would build, every counted symbol is coded
+	unique = buildCodeLengths(table, code_counts, max_len);
+	double bits = (double) getEncodedBits(table, counts) * scale;
+	freeTable(table);
+
+	//code table, then the bit length and any odd character of every block
+	size = sizeof(unsigned int) + unique * (width + 1);
+	size += blocks * sizeof(unsigned int) + total % width;
+	size += (unsigned long long) ceil(bits / 8);
+	return size;
+}
+
+/* Counts the characters, and the byte pairs when asked to, of a part of the input */
+static void countSymbols(const unsigned char *data, size_t len,
+		unsigned int *counts, unsigned int *pair_counts) {
+	for (size_t i = 0; i < len; i++)
+		counts[data[i]]++;
+
+	if (pair_counts != NULL)
+		for (size_t i = 0; i + 1 < len; i += 2)
+			pair_counts[(data[i] << 8) | data[i + 1]]++;
+}
+
+/* Reads the whole input, or evenly spread blocks of it when it is large, and counts it.
+ Levels that sample their histograms also get the counts their codes are built from */
+static bool sampleFile(FILE *iFile, unsigned long long blocks,
+		const EncodeOptions *options, unsigned int *counts,
+		unsigned int *pair_counts, unsigned int *code_counts,
+		unsigned long long *sampled) {
+	unsigned int block_size = options->block_size;
+	unsigned char *buffer = (unsigned char*) malloc(block_size);
+	unsigned long long picks = blocks;
+	bool success = buffer != NULL;
+
+	if (blocks * block_size > SAMPLE_THRESHOLD && blocks > SAMPLE_BLOCKS)
+		picks = SAMPLE_BLOCKS;
+
+	*sampled = 0;
+	for (unsigned long long i = 0; success && i < picks; i++) {
+		//whole blocks, so byte pairs line up the way they are encoded
+		unsigned long long block = i * blocks / picks;
+		size_t len = 0;
+
+		success = fseek(iFile, block * block_size, SEEK_SET) == 0;
+		if (success) {
+			len = fread(buffer, 1, block_size, iFile);
+			success = ferror(iFile) == 0;
+		}
+		countSymbols(buffer, len, counts, pair_counts);
+		*sampled += len;
+
+		//sampled per block, as the encoder does
+		if (code_counts != NULL && len > 0) {
+			unsigned int block_counts[MAX_CHARS] = { 0 };
+			countChars(buffer, (unsigned int) len, options->sample_step,
+					block_counts);
+			for (int c = 0; c < MAX_CHARS; c++)
+				code_counts[c] += block_counts[c];
+		}
+	}
+
+	free(buffer);
+	return success;
+}
+
+/* Estimates how well a file compresses without encoding it, from its symbol counts */
+bool estimateFile(FILE *iFile, const EncodeOptions *options,
+		Estimate *estimate) {
+	unsigned int counts[MAX_CHARS] = { 0 };
+	unsigned int sampled_counts[MAX_CHARS] = { 0 };
+	unsigned int *code_counts = options->sample_step > 1 ? sampled_counts : NULL;
+	unsigned int *pair_counts = NULL;
+
+	memset(estimate, 0, sizeof(*estimate));
+	if (fseek(iFile, 0, SEEK_END) != 0)
+		return false;
+	estimate->total = ftell(iFile);
+
+	unsigned long long blocks = (estimate->total + options->block_size - 1)
+			/ options->block_size;
+
+	if (options->word_symbols
+			&& (pair_counts = (unsigned int*) calloc(MAX_WORDS,
+					sizeof(unsigned int))) == NULL)
+		return false;
+
+	if (!sampleFile(iFile, blocks, options, counts, pair_counts, code_counts,
+			&estimate->sampled)) {
+		free(pair_counts);
+		return false;
+	}
+
+	double scale =
+			estimate->sampled > 0 ?
+					(double) estimate->total / estimate->sampled : 0;
+	for (int i = 0; i < MAX_CHARS; i++)
+		if (counts[i] > 0)
+			estimate->unique++;
+
+	estimate->entropy = getEntropy(counts, MAX_CHARS);
+	estimate->huffman_size = getHuffmanSize(counts,
+			code_counts != NULL ? code_counts : counts, MAX_CHARS, 1,
+			options->max_code_len, scale, blocks, estimate->total);
+
+	//byte pairs are kept when they beat single characters, as when encoding
+	if (pair_counts != NULL) {
+		unsigned long long pair_size = getHuffmanSize(pair_counts, pair_counts,
+				MAX_WORDS, 2, options->max_code_len, scale, blocks,
+				estimate->total);
+		if (pair_size < estimate->huffman_size) {
+			estimate->word_symbols = true;
+			estimate->huffman_size = pair_size;
+			estimate->entropy = getEntropy(pair_counts, MAX_WORDS) / 2;
+		}
+		free(pair_counts);
+	}
+
+	estimate->shannon_size = (unsigned long long) ceil(
+			estimate->entropy * estimate->total / 8);
+
+	//each block falls back to a run or to being stored raw, as when encoding
+	unsigned long long size = estimate->total;
+	if (estimate->unique == 1)
+		size = blocks;
+	else if (estimate->huffman_size < size)
+		size = estimate->huffman_size;
+
+	estimate->encoded_size = MAGIC_SIZE + blocks * (BLOCK_HEADER + ENTRY_SIZE)
+			+ size + FOOTER_SIZE;
+	estimate->compressible = estimate->encoded_size < estimate->total;
+	return true;
+}
@@ -0,0 +1,37 @@
+/*
+ -------------------------------------
+ File:    estimate.h
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#ifndef ESTIMATE_H_
+#define ESTIMATE_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "block.h"
+
+#define SAMPLE_THRESHOLD	(1ULL << 26)	//inputs larger than 64 MB are sampled
+#define SAMPLE_BLOCKS	256	//blocks counted on sampled inputs, spread over the whole input
+
+typedef struct Estimate {
+	unsigned long long total;	//characters in the input
+	unsigned long long sampled;	//characters counted, fewer than total on sampled inputs
+	unsigned int unique;		//distinct symbols counted
+	bool word_symbols;			//the estimate is for byte pair symbols
+	double entropy;				//Shannon entropy in bits per character
+	unsigned long long shannon_size;	//entropy bound of the coded characters, in bytes
+	unsigned long long huffman_size;	//Huffman coded characters and their table, in bytes
+	unsigned long long encoded_size;	//expected size of the compressed file
+	bool compressible;			//the compressed file would be smaller than the input
+} Estimate;
+
+bool estimateFile(FILE *iFile, const EncodeOptions *options,
+		Estimate *estimate);
+
+#endif /* ESTIMATE_H_ */
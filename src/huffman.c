@@ -4,23 +4,86 @@
  Project: Huffman TXT Compressor
  -------------------------------------
  Author:	Roy Ceyleon
- Version:	2020-11-30
+ Version:	2026-10-19
  -------------------------------------
  ***THIS COMPRESSION IS NOT OPTIMAL FOR COMPRESSING .TXT FILES UNDER 250 BYTES, AS THE SAVINGS ARE NEGLIGIBLE OR NONEXISTENT.***
 
 
- ENCODING USAGE: ./huffman encode <input file> <output file>
- DECODING USAGE: ./huffman decode <input file> <output file>
+ ENCODING USAGE: ./huffman encode [-1..-9] [-w] [--memory-limit <size>] <input file> <output file>
+ DECODING USAGE: ./huffman decode [--memory-limit <size>] <input file> <output file>
+ VERIFYING USAGE: ./huffman verify [--memory-limit <size>] <original file> <compressed file>
+ APPENDING USAGE: ./huffman append [-1..-9] [-w] [--memory-limit <size>] <input file> <output file>
+ ESTIMATING USAGE: ./huffman estimate [-1..-9] [-w] [--memory-limit <size>] <input file>
+
+ Every mode exits with 0 when it succeeds and 1 when it fails.
+
+ OPTIONS
+ - -w also tries byte pairs as 16-bit symbols on every block, which suits logs and other ASCII text
+ - -1 to -9 pick the compression level, from fastest to smallest output, -5 by default
+   -1 to -3 build tables from sampled histograms and repeat them more freely, on larger blocks
+   at -1 and -2, and only code single characters, in at most 12 bits so they pack and unpack
+   faster at the cost of a slightly larger output
+   -4 to -6 build tables from exact histograms of fixed size blocks
+   -7 to -9 read 1 MB at a time and split it into blocks where the histogram shifts, comparing
+   16 KB, 8 KB and 4 KB chunks, and repeat tables less freely
+ - --memory-limit caps the working memory, in bytes or with a K, M or G suffix, see MEMORY LIMITS
+
+ APPENDING
+ - The input file is a grown version of the file that was compressed into the output file,
+   only the characters past the ones already compressed are encoded and added as new blocks
+ - When appending fails partway, the old index is written back and the output file is left as it was
+
+ VERIFYING
+ - Decodes every block of the compressed file and compares it with its part of the original file,
+   failing on the first block that does not decode or does not match
+
+ ESTIMATING
+ - Prints the entropy of the input, its Shannon bound, the size of the Huffman code the level
+   builds and the expected size of the compressed file without writing anything, and whether
+   compressing pays off
+ - Inputs over 64 MB are estimated from 256 blocks spread evenly over the file
+
+ LARGE FILES
+ - On Linux, encoding and appending inputs of 32 blocks or more read and write through io_uring,
+   keeping reads of the next blocks and writes of the finished ones in flight while encoding,
+   and fall back to regular file I/O when io_uring is unavailable
+
+ MEMORY LIMITS
+ - Encoding, appending and estimating fit the blocks in flight, the blocks, the tables and the
+   worst case tree they are built from, the table cache and the block index of the input into
+   the limit. Fewer blocks are kept in flight first,
+   then blocks shrink to 64 KB (256 KB with -w), then I/O turns blocking, then byte pairs and
+   splitting are dropped and finally blocks shrink to 4 KB, failing when even that does not fit
+ - Blocks are kept small enough to decode and verify within the same limit
+ - Decoding and verifying fail before writing anything when the largest block of the compressed
+   file does not fit into the limit
+ - The table cache gets at most a quarter of the limit
 
  KNOWN LIMITATIONS
- - File to be compressed cannot contain more than 4,294,967,295 characters in total.
-
- INFOMATION ABOUT COMPRESSED FILE HEADER:
- - First 4 bytes store the number of total characters found in the original file
- - The next 5-6 bytes store the number of unique characters found in the uncompressed file
- - The next 7-8 bytes store the length of the Huffman encoded binary string
- - An arbitrry length of bytes following 8th byte contain frequency table
- - Following the frequency table is the Huffman encoded binary string
+ - Appending does not check that the start of the input file is unchanged since it was compressed
+
+ INFOMATION ABOUT COMPRESSED FILE:
+ - First 4 bytes store the magic "HUF1"
+ - Following the magic is a sequence of blocks, each covering part of the original file (64 KB at
+   the default level, at most 16 MB)
+ - Following the blocks is the block index, 13 bytes per block storing the offset of the block
+   in the compressed file (8 bytes), the number of characters in the block (4 bytes) and its type
+ - The last 24 bytes are the footer, storing the offset of the block index (8 bytes), the number
+   of blocks (4 bytes), the number of total characters found in the original file (8 bytes) and
+   the magic "HUF1" again
+
+ INFOMATION ABOUT COMPRESSED BLOCKS:
+ - First byte stores the block type (0 - RAW, 1 - RLE, 2 - HUFFMAN, 3 - HUFFMAN16, 4 - REPEAT)
+ - The next 4 bytes store the number of characters in the block
+ - RAW blocks follow with the characters as is
+ - RLE blocks follow with the single character repeated throughout the block
+ - HUFFMAN blocks follow with 4 bytes for the number of unique characters, the code length table
+   (character and code length), 4 bytes for the length of the Huffman encoded binary string and
+   the Huffman encoded binary string
+ - HUFFMAN16 blocks have the same layout with 2 byte symbols made of byte pairs, and the last
+   character of an odd length block stored as is before the binary string
+ - REPEAT blocks reuse the code length table of the last HUFFMAN or HUFFMAN16 block, and follow
+   with only the length of the binary string, the odd character and the binary string
 
  */
 
@@ -29,47 +92,87 @@
 #include <stdbool.h>
 #include <ctype.h>
 #include <string.h>
-#include <math.h>
 #include <limits.h>
+#include <stdint.h>
 #include <time.h>
+#include <unistd.h>
 
 #include "tree.h"
 #include "pQueue.h"
 #include "utilities.h"
+#include "block.h"
+#include "container.h"
+#include "uring.h"
+#include "estimate.h"
+#include "budget.h"
+
+//Debug Setting, set by the build (0 - Disable Debugging), (1 - Enable Debugging)
+#ifndef DEBUG_MODE
+#define DEBUG_MODE 0
+#endif
 
-//Debug Setting
-#define DEBUG_MODE 1 //(0 - Disable Debugging), (1 - Enable Debugging)
-
-//Macro Definitions
-#define MAX_CHARS	256
-#define BUFFER_LIMIT pow(2,15) //set to a higher power of 2 to handle txt files larger than 80 MB
+//Asynchronous I/O Settings
+#define URING_MIN_BLOCKS	32	//smaller inputs are encoded with blocking I/O
 
 //Global Variables
-char char_list[MAX_CHARS] = { 0 };
+unsigned char char_list[MAX_CHARS] = { 0 };
 int char_count[MAX_CHARS] = { 0 };
-char char_encoding[MAX_CHARS][100] = { { '\0' } };
-unsigned int total_char_count = 0;
+unsigned long long total_char_count = 0;
 short unique_char_count = 0;
-char *inputFileName = NULL;
-char *outputFileName = NULL;
-unsigned int bit_len = 0;
 
 //Function Declarations
-void getCharCounts(char *msg);
-void analyse_file();
+void getCharCounts(char *msg, size_t len);
 void printBT(BT *bt);
 void printAnalysis();
-void getCharEncoding(TNode *node, char *str);
-void _getCharEncoding(TNode *node, TNode *next_node, char *str);
-bool createEncodedFile();
-bool encodeFile(char *in, char *out);
-bool decodeFile(char *in, char *out);
+bool encodeFile(char *in, char *out, const EncodeOptions *options);
+bool decodeFile(char *in, char *out, size_t limit);
+bool verifyFile(char *original, char *compressed, size_t limit);
+bool appendFile(char *in, char *out, const EncodeOptions *options);
+bool reportEstimate(char *in, const EncodeOptions *options);
+bool parseSize(const char *text, size_t *size);
+bool fitMemory(char *in, EncodeOptions *options, size_t limit,
+		bool estimating);
 
 /* Main Function */
 int main(int argc, char **argv) {
-	if (argc < 4 || argc > 4) {
-		printf("ENCODING USAGE: ./huffman encode <input file> <output file>\n");
-		printf("DECODING USAGE: ./huffman decode <input file> <output file>\n");
+	EncodeOptions options;
+	bool word_symbols = false;
+	int level = DEFAULT_LEVEL;
+	size_t limit = 0;
+	char *args[3] = { NULL };
+	int nargs = 0;
+
+	//separate the options from the mode and file names
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-w") == 0) {
+			word_symbols = true;
+		} else if (strcmp(argv[i], "--memory-limit") == 0) {
+			if (i + 1 >= argc || !parseSize(argv[++i], &limit)) {
+				printf("ERROR: Invalid memory limit.\n");
+				return 1;
+			}
+		} else if (argv[i][0] == '-' && argv[i][1] >= '0' + MIN_LEVEL
+				&& argv[i][1] <= '0' + MAX_LEVEL && argv[i][2] == '\0') {
+			level = argv[i][1] - '0';
+		} else if (nargs < 3) {
+			args[nargs++] = argv[i];
+		} else {
+			nargs++;
+		}
+	}
+	initializeOptions(&options, level, word_symbols);
+
+	//estimating only reads the input file
+	if (nargs != (nargs > 0 && strcmp(args[0], "estimate") == 0 ? 2 : 3)) {
+		printf("ENCODING USAGE: ./huffman encode [-1..-9] [-w] [--memory-limit <size>] <input file> <output file>\n");
+		printf("DECODING USAGE: ./huffman decode [--memory-limit <size>] <input file> <output file>\n");
+		printf("VERIFYING USAGE: ./huffman verify [--memory-limit <size>] <original file> <compressed file>\n");
+		printf("APPENDING USAGE: ./huffman append [-1..-9] [-w] [--memory-limit <size>] <input file> <output file>\n");
+		printf("ESTIMATING USAGE: ./huffman estimate [-1..-9] [-w] [--memory-limit <size>] <input file>\n");
+		printf("  -1..-9  compression level, faster to smaller (default -%d)\n",
+				DEFAULT_LEVEL);
+		printf("  -w  also encode byte pairs as 16-bit symbols\n");
+		printf("  --memory-limit  working memory cap, in bytes or with a K, M or G suffix\n");
 		return 1;
 	}
 
@@ -79,398 +182,668 @@ int main(int argc, char **argv) {
 
 	bool success = false;
 
-	if (strcmp(argv[1], "encode") == 0) {
-		if (strcmp(argv[2], argv[3]) == 0) {
+	if (strcmp(args[0], "encode") == 0) {
+		if (strcmp(args[1], args[2]) == 0) {
 			printf("ERROR: Input file same as Output file.");
-			return 0;
+			return 1;
 		}
-		success = encodeFile(argv[2], argv[3]);
+		success = fitMemory(args[1], &options, limit, false)
+				&& encodeFile(args[1], args[2], &options);
 
 #if DEBUG_MODE == 0
-		printf("ENCODE[%s]->%s\n", argv[2], argv[3]);
+		printf("ENCODE[%s]->%s\n", args[1], args[2]);
 		printf("ENCODING %s\n", success ? "SUCCESSFUL" : "FAILED");
 #endif
 
-	} else if (strcmp(argv[1], "decode") == 0) {
-		if (strcmp(argv[2], argv[3]) == 0) {
+	} else if (strcmp(args[0], "decode") == 0) {
+		if (strcmp(args[1], args[2]) == 0) {
 			printf("ERROR: Input file same as Output file.");
-			return 0;
+			return 1;
 		}
-		success = decodeFile(argv[2], argv[3]);
+		success = decodeFile(args[1], args[2], limit);
 
 #if DEBUG_MODE == 0
-		printf("DECODE[%s]->%s\n", argv[2], argv[3]);
+		printf("DECODE[%s]->%s\n", args[1], args[2]);
 		printf("DECODING %s\n", success ? "SUCCESSFUL" : "FAILED");
 #endif
 
+	} else if (strcmp(args[0], "verify") == 0) {
+		if (strcmp(args[1], args[2]) == 0) {
+			printf("ERROR: Input file same as Output file.");
+			return 1;
+		}
+		success = verifyFile(args[1], args[2], limit);
+
+#if DEBUG_MODE == 0
+		printf("VERIFY[%s]->%s\n", args[1], args[2]);
+		printf("VERIFYING %s\n", success ? "SUCCESSFUL" : "FAILED");
+#endif
+
+	} else if (strcmp(args[0], "append") == 0) {
+		if (strcmp(args[1], args[2]) == 0) {
+			printf("ERROR: Input file same as Output file.");
+			return 1;
+		}
+		success = fitMemory(args[1], &options, limit, false)
+				&& appendFile(args[1], args[2], &options);
+
+#if DEBUG_MODE == 0
+		printf("APPEND[%s]->%s\n", args[1], args[2]);
+		printf("APPENDING %s\n", success ? "SUCCESSFUL" : "FAILED");
+#endif
+
+	} else if (strcmp(args[0], "estimate") == 0) {
+		success = fitMemory(args[1], &options, limit, true)
+				&& reportEstimate(args[1], &options);
+
+#if DEBUG_MODE == 0
+		printf("ESTIMATING %s\n", success ? "SUCCESSFUL" : "FAILED");
+#endif
+
 	} else
 		printf("USAGE ERROR: Invalid Arguments");
 
 #if DEBUG_MODE == 1
 	clock_t end = clock();
+	printf("Result: %s\n", success ? "SUCCESSFUL" : "FAILED");
 	printf("Execution Time: %lf sec.", (double) (end - begin) / CLOCKS_PER_SEC);
 #endif
 
-	return 0;
+	return success ? 0 : 1;
 }
 
 /* Function to Decode File*/
-bool decodeFile(char *in, char *out) {
-	inputFileName = malloc(sizeof(in));
-	outputFileName = malloc(sizeof(out));
-	strcpy(inputFileName, in);
-	strcpy(outputFileName, out);
-
+bool decodeFile(char *in, char *out, size_t limit) {
 	FILE *iFile = NULL;
 	FILE *oFile = NULL;
+	BlockIndex index;
+	BlockState state = { NULL };
+	bool success = true;
 
-	// Parse the header
-	char c = 0;
-	int count = 0;
-	char *bitstring = NULL;
-	if ((iFile = fopen(inputFileName, "rb")) != NULL) {
-		fread(&total_char_count, sizeof(total_char_count), 1, iFile);
-		fread(&unique_char_count, sizeof(unique_char_count), 1, iFile);
-		fread(&bit_len, sizeof(bit_len), 1, iFile);
-
-		if (total_char_count < 1 || unique_char_count < 1 || bit_len < 1) {
-			fclose(iFile);
-			return false;
-		}
+	// Parse the header and the block index
+	if ((iFile = fopen(in, "rb")) == NULL)
+		return false;
+
+	if (!readIndex(iFile, &index)) {
+		fclose(iFile);
+		return false;
+	}
+	total_char_count = index.total;
+
+	//nothing is written when the blocks would not fit
+	if (limit > 0 && getDecodeMemory(&index, 1) > limitTableCache(limit)) {
+		printf("ERROR: Blocks of %s do not fit in the memory limit.\n", in);
+		freeIndex(&index);
+		fclose(iFile);
+		return false;
+	}
 
 #if DEBUG_MODE == 1
-		printf("----HEADER INFORMATION----\n");
-		printf("Total Chars: %d\n", total_char_count);
-		printf("Unique Chars: %d\n", unique_char_count);
-		printf("Bit Length: %d\n", bit_len);
+	printf("----HEADER INFORMATION----\n");
+	printf("Total Chars: %llu\n", total_char_count);
+	printf("Blocks: %u\n", index.count);
 #endif
 
-		for (int i = 0; i < unique_char_count; i++) {
-			fread(&c, sizeof(char), 1, iFile);
-			fread(&count, sizeof(unsigned int), 1, iFile);
-			char_count[(int) c] = count;
-		}
+	if ((oFile = fopen(out, "wb")) == NULL) {
+		freeIndex(&index);
+		fclose(iFile);
+		return false;
+	}
 
-		//Create tree nodes with symbols and their respective weights, and insert into Queue
-		PriorityQueue *pQ = createPQueue();
-		for (int i = 0; i < sizeof(char_count); i++) {
-			if (char_count[i] > 0) {
-				TNode *new_node = (TNode*) malloc(sizeof(TNode));
-				new_node->parent = NULL;
-				new_node->left = NULL;
-				new_node->right = NULL;
-				new_node->symbol = (char) i;
-				new_node->weight = char_count[i];
-				enqueuePQueue(pQ, new_node);
-			}
-		}
+	//decode block by block into memory, each one has to match its index entry
+	unsigned char *block = (unsigned char*) malloc(getMaxBlockLen(&index) + 1);
+	success = block != NULL;
+	fseek(iFile, MAGIC_SIZE, SEEK_SET);
+	for (unsigned int i = 0; success && i < index.count; i++) {
+		success = decodeEntry(iFile, &index, i, block, &state)
+				&& fwrite(block, 1, index.entries[i].len, oFile)
+						== index.entries[i].len;
 
-		//Build Huffman Tree
-		while (pQ->size > 1) {
-			TNode *n1 = dequeuePQueue(pQ);
-			TNode *n2 = dequeuePQueue(pQ);
-			TNode *new_node = (TNode*) malloc(sizeof(TNode));
-			new_node->left = n1;
-			new_node->right = n2;
-			n1->parent = new_node;
-			n2->parent = new_node;
-			new_node->weight = n1->weight + n2->weight;
-			new_node->symbol = '\0';
-			enqueuePQueue(pQ, new_node);
-		}
+#if DEBUG_MODE == 1
+		printf("Block @%llu: %s, %u chars\n", index.entries[i].offset,
+				blockTypeName(index.entries[i].type), index.entries[i].len);
+#endif
+	}
+	free(block);
 
-		BT *bt = (BT*) malloc(sizeof(BT));
-		initializeBT(bt, dequeuePQueue(pQ));
+	//the last block has to end where the index starts
+	if ((unsigned long long) ftell(iFile) != index.end)
+		success = false;
 
 #if DEBUG_MODE == 1
-		printBT(bt);
-		//	printf("Huffman Binary Encoding:\n");
-		//	printf("%s\n", bitstring);
+	printf("Generated Uncompressed File: %s\n", out);
 #endif
 
-		//Traverse tree and decode the file
-		if ((oFile = fopen(outputFileName, "wb")) != NULL) {
-			unsigned int processed = 0;
-			bitstring = (char*) calloc(UINT_MAX, sizeof(char));
-			unsigned char ch;
-			size_t check;
-
-			//decode encoded binary in chunks of 1024 bits and write
-			while ((check = fread(&ch, sizeof(char), 1, iFile)) > 0) {
-				strcat(bitstring, dec2bin((unsigned int )ch));
-
-				if (strlen(bitstring) >= 1024) {
-					int written = 0;
-					TNode *current = bt->root;
-					for (int i = 0; i < strlen(bitstring); i++) {
-						processed++;
-						if (bitstring[i] == '0')
-							current = current->left;
-						else
-							current = current->right;
-
-						if (current->symbol != '\0') {
-							fwrite(&current->symbol, 1, sizeof(char), oFile);
-							current = bt->root;
-							if (++written > 10) {
-								stringSlice(bitstring, bitstring, i + 1,
-										strlen(bitstring));
-								break;
-							}
-						}
-
-					}
-				}
+	freeBlockState(&state);
+	freeIndex(&index);
+	fclose(iFile);
+	fclose(oFile);
 
-			}
+	return success;
+}
 
-			//write any leftover bits
-			TNode *current = bt->root;
-			for (int i = 0; i < bit_len - processed; i++) {
-				if (bitstring[i] == '0')
-					current = current->left;
-				else
-					current = current->right;
-
-				if (current->symbol != '\0') {
-					fwrite(&current->symbol, 1, sizeof(char), oFile);
-					current = bt->root;
-				}
-			}
+/* Function to Verify that a compressed File decodes back to its original File */
+bool verifyFile(char *original, char *compressed, size_t limit) {
+	FILE *iFile = NULL;
+	FILE *cFile = NULL;
+	BlockIndex index;
+	BlockState state = { NULL };
+	unsigned char *expected = NULL;
+	unsigned char *decoded = NULL;
 
-		} else {
-			free(bt);
-			free(bitstring);
-			return false;
-		}
+	if ((cFile = fopen(compressed, "rb")) == NULL)
+		return false;
+
+	if (!readIndex(cFile, &index)) {
+		fclose(cFile);
+		return false;
+	}
+
+	//the decoded block and its part of the original are held side by side
+	if (limit > 0 && getDecodeMemory(&index, 2) > limitTableCache(limit)) {
+		printf("ERROR: Blocks of %s do not fit in the memory limit.\n",
+				compressed);
+		freeIndex(&index);
+		fclose(cFile);
+		return false;
+	}
+
+	//every block is decoded on its own and compared with its part of the original
+	unsigned int max_len = getMaxBlockLen(&index);
+	iFile = fopen(original, "rb");
+	expected = (unsigned char*) malloc(max_len + 1);
+	decoded = (unsigned char*) malloc(max_len + 1);
+	bool success = iFile != NULL && expected != NULL && decoded != NULL;
+
+	fseek(cFile, MAGIC_SIZE, SEEK_SET);
+	for (unsigned int i = 0; success && i < index.count; i++) {
+		unsigned int len = index.entries[i].len;
+
+		success = decodeEntry(cFile, &index, i, decoded, &state)
+				&& fread(expected, 1, len, iFile) == len
+				&& memcmp(expected, decoded, len) == 0;
 
 #if DEBUG_MODE == 1
-		printf("Generated Uncompressed File: %s\n", outputFileName);
+		if (!success)
+			printf("Block %u @%llu: does not match the original\n", i,
+					index.entries[i].offset);
 #endif
+	}
+
+	//both files have to end with the last block
+	success = success && (unsigned long long) ftell(cFile) == index.end
+			&& fgetc(iFile) == EOF;
+
+#if DEBUG_MODE == 1
+	printf("Verified %u blocks, %llu chars: %s\n", index.count, index.total,
+			success ? "MATCH" : "MISMATCH");
+#endif
+
+	free(expected);
+	free(decoded);
+	freeBlockState(&state);
+	freeIndex(&index);
+	if (iFile != NULL)
 		fclose(iFile);
-		fclose(oFile);
-	} else
-		return false;
+	fclose(cFile);
 
-	return true;
+	return success;
 }
 
-/* Function to Encode File*/
-bool encodeFile(char *in, char *out) {
+/* Encodes len characters of input into encoded as one or more blocks, recording
+ each block in the index. offset is where encoded will be written in the output */
+static bool encodeSegments(const unsigned char *data, unsigned int len,
+		unsigned char *encoded, size_t *size, unsigned long long offset,
+		const EncodeOptions *options, BlockIndex *index, BlockState *state) {
+	unsigned int pos = 0;
+	bool success = true;
 
-	//set filenames for global access
-	inputFileName = malloc(sizeof(in));
-	outputFileName = malloc(sizeof(out));
-	strcpy(inputFileName, in);
-	strcpy(outputFileName, out);
+	*size = 0;
+	while (success && pos < len) {
+		unsigned int seg = splitBlock(data + pos, len - pos, options);
+		size_t n = 0;
+		BlockType type;
 
-	//Analyse and Prints results
-	analyse_file();
+		success = encodeBlock(data + pos, seg, encoded + *size, &n, options,
+				state, &type)
+				&& addBlockEntry(index, offset + *size, seg, type);
 
 #if DEBUG_MODE == 1
-	printAnalysis();
-	printf("\n");
+		printf("Block @%llu: %s, %u chars\n", offset + *size,
+				blockTypeName(type), seg);
 #endif
 
-	//Create tree nodes with symbols and their respective weights, and insert into Queue
-	PriorityQueue *pQ = createPQueue();
-	for (int i = 0; i < sizeof(char_count); i++) {
-		if (char_count[i] > 0) {
-			TNode *new_node = (TNode*) malloc(sizeof(TNode));
-			new_node->parent = NULL;
-			new_node->left = NULL;
-			new_node->right = NULL;
-			new_node->symbol = (char) i;
-			new_node->weight = char_count[i];
-			enqueuePQueue(pQ, new_node);
-		}
+		*size += n;
+		pos += seg;
 	}
 
-	//Build Huffman Tree
-	while (pQ->size > 1) {
-		TNode *n1 = dequeuePQueue(pQ);
-		TNode *n2 = dequeuePQueue(pQ);
-		TNode *new_node = (TNode*) malloc(sizeof(TNode));
-		new_node->left = n1;
-		new_node->right = n2;
-		n1->parent = new_node;
-		n2->parent = new_node;
-		new_node->weight = n1->weight + n2->weight;
-		new_node->symbol = '\0';
-		enqueuePQueue(pQ, new_node);
-	}
+	return success;
+}
+
+/* Encodes the rest of the input one block at a time, recording each block in the index */
+static bool encodeBlocks(FILE *iFile, FILE *oFile,
+		const EncodeOptions *options, BlockIndex *index, BlockState *state) {
+	unsigned char *block = (unsigned char*) malloc(options->block_size);
+	unsigned char *encoded = (unsigned char*) malloc(
+			getEncodedBound(options));
+	size_t len = 0;
+	bool success = block != NULL && encoded != NULL;
 
-	//Print BT
-	BT *bt = (BT*) malloc(sizeof(BT));
-	initializeBT(bt, dequeuePQueue(pQ));
+	while (success
+			&& (len = fread(block, 1, options->block_size, iFile)) > 0) {
+		size_t size = 0;
 
 #if DEBUG_MODE == 1
-	printBT(bt);
+		getCharCounts((char*) block, len);
 #endif
 
-	//Get New Char Encodings
-	char str[50] = "";
-	getCharEncoding(bt->root, str);
+		success = encodeSegments(block, (unsigned int) len, encoded, &size,
+				ftell(oFile), options, index, state)
+				&& fwrite(encoded, 1, size, oFile) == size;
+	}
 
-#if DEBUG_MODE == 1
-	printf("\n");
-	printf("----CHAR ENCODINGS----\n");
+	free(block);
+	free(encoded);
+	return success && ferror(iFile) == 0;
+}
+
+/* Encodes the rest of the input like encodeBlocks, keeping several reads and writes
+ in flight through io_uring. Returns false when the ring is not used, so the caller
+ can fall back to blocking I/O, and the result of the encoding in success otherwise */
+static bool encodeBlocksAsync(FILE *iFile, FILE *oFile,
+		const EncodeOptions *options, BlockIndex *index, BlockState *state,
+		bool *success) {
+	void *buffers[2 * QUEUE_DEPTH] = { NULL };
+	size_t sizes[2 * QUEUE_DEPTH];
+	unsigned int read_len[QUEUE_DEPTH] = { 0 };
+	unsigned int read_done[QUEUE_DEPTH] = { 0 };
+	unsigned int write_len[QUEUE_DEPTH] = { 0 };
+	unsigned int write_done[QUEUE_DEPTH] = { 0 };
+	unsigned long long write_offset[QUEUE_DEPTH] = { 0 };
+	bool writing[QUEUE_DEPTH] = { false };
+	Ring *ring = NULL;
+	int depth = (int) options->queue_depth;
+	int in_fd = fileno(iFile);
+	int out_fd = fileno(oFile);
+
+	//only worth it for large inputs with room for several blocks, others block
+	unsigned long long in_offset = ftell(iFile);
+	fseek(iFile, 0, SEEK_END);
+	unsigned long long in_end = ftell(iFile);
+	fseek(iFile, in_offset, SEEK_SET);
+	unsigned long long blocks = (in_end - in_offset + options->block_size - 1)
+			/ options->block_size;
+	if (depth < 2 || depth > QUEUE_DEPTH || blocks < URING_MIN_BLOCKS
+			|| fflush(oFile) != 0)
+		return false;
+	unsigned long long out_offset = ftell(oFile);
+
+	//the first half of the buffers hold input blocks, the second half encoded blocks
+	for (int i = 0; i < 2 * depth; i++) {
+		sizes[i] = i < depth ?
+				options->block_size : getEncodedBound(options);
+		if ((buffers[i] = malloc(sizes[i])) == NULL)
+			break;
+	}
+	if (buffers[2 * depth - 1] != NULL)
+		ring = createRing(2 * depth, buffers, sizes, 2 * depth);
+	if (ring == NULL) {
+		for (int i = 0; i < 2 * depth; i++)
+			free(buffers[i]);
+		return false;
+	}
+
+	//requests are tagged with their slot, and whether they are a write
+	unsigned long long next_read = 0;
+	unsigned long long next_encode = 0;
+	unsigned int writes = 0;
+	unsigned int inflight = 0;
+	bool ok = true;
+
+	for (; next_read < blocks && next_read < (unsigned int) depth; next_read++) {
+		int slot = next_read % depth;
+		unsigned long long offset = in_offset + next_read * options->block_size;
+		read_len[slot] = (unsigned int) (
+				in_end - offset < options->block_size ?
+						in_end - offset : options->block_size);
+		ok = ok && queueRead(ring, in_fd, slot, buffers[slot], read_len[slot],
+				offset, (unsigned long long) slot << 1);
+		inflight += ok;
+	}
+	ok = ok && submitRing(ring);
 
-	for (int i = 0; char_list[i] != '\0'; i++)
-		printf("%c - %s\n", char_list[i] == '\n' ? '|' : char_list[i],
-				char_encoding[(int) char_list[i]]);
+	while (ok && (next_encode < blocks || writes > 0)) {
+		int slot = next_encode % depth;
 
+		//encode the next block once it has been read and its output buffer is free
+		if (next_encode < blocks && read_done[slot] == read_len[slot]
+				&& !writing[slot]) {
+			unsigned char *block = (unsigned char*) buffers[slot];
+			unsigned int len = read_len[slot];
+			size_t size = 0;
+
+#if DEBUG_MODE == 1
+			getCharCounts((char*) block, len);
 #endif
 
-	return createEncodedFile();
+			ok = encodeSegments(block, len, buffers[depth + slot], &size,
+					out_offset, options, index, state);
+
+			write_len[slot] = (unsigned int) size;
+			write_done[slot] = 0;
+			write_offset[slot] = out_offset;
+			writing[slot] = true;
+			writes++;
+			out_offset += size;
+			ok = ok && queueWrite(ring, out_fd, depth + slot,
+					buffers[depth + slot], write_len[slot],
+					write_offset[slot], ((unsigned long long) slot << 1) | 1);
+			inflight += ok;
+			next_encode++;
+
+			//the input buffer is free again, read ahead into it
+			read_done[slot] = 0;
+			read_len[slot] = 0;
+			if (ok && next_read < blocks) {
+				unsigned long long offset = in_offset
+						+ next_read * options->block_size;
+				read_len[slot] = (unsigned int) (
+						in_end - offset < options->block_size ?
+								in_end - offset : options->block_size);
+				ok = queueRead(ring, in_fd, slot, buffers[slot],
+						read_len[slot], offset, (unsigned long long) slot << 1);
+				inflight += ok;
+				next_read++;
+			}
+			ok = ok && submitRing(ring);
+			continue;
+		}
+
+		unsigned long long tag = 0;
+		int result = 0;
+		if (!(ok = waitRing(ring, &tag, &result)))
+			break;
+		inflight--;
+
+		int done_slot = (int) (tag >> 1);
+		if (result <= 0) {
+			//errors, and running into the end of the input early
+			ok = false;
+		} else if (tag & 1) {
+			//finish short writes before releasing the buffer
+			write_done[done_slot] += result;
+			if (write_done[done_slot] < write_len[done_slot]) {
+				unsigned int done = write_done[done_slot];
+				ok = queueWrite(ring, out_fd, depth + done_slot,
+						(char*) buffers[depth + done_slot] + done,
+						write_len[done_slot] - done,
+						write_offset[done_slot] + done, tag);
+				inflight += ok;
+				ok = ok && submitRing(ring);
+			} else {
+				writing[done_slot] = false;
+				writes--;
+			}
+		} else {
+			//finish short reads before encoding the block
+			read_done[done_slot] += result;
+			if (read_done[done_slot] < read_len[done_slot]) {
+				unsigned int done = read_done[done_slot];
+				unsigned long long block = next_encode
+						+ (done_slot - slot + depth) % depth;
+				ok = queueRead(ring, in_fd, done_slot,
+						(char*) buffers[done_slot] + done,
+						read_len[done_slot] - done,
+						in_offset + block * options->block_size + done, tag);
+				inflight += ok;
+				ok = ok && submitRing(ring);
+			}
+		}
+	}
+
+	//the kernel may still be using the buffers after a failure
+	unsigned long long tag = 0;
+	int result = 0;
+	while (inflight > 0 && submitRing(ring) && waitRing(ring, &tag, &result))
+		inflight--;
+
+	//carry on with stdio after the last block
+	fseek(iFile, in_end, SEEK_SET);
+	fseek(oFile, out_offset, SEEK_SET);
+
+	freeRing(ring);
+	for (int i = 0; i < 2 * depth; i++)
+		free(buffers[i]);
+
+	*success = ok;
+	return true;
 }
 
-//Builds the encoded file
-bool createEncodedFile() {
-	FILE *file = NULL;
-	char *txt_buffer = 0;
-	unsigned long txt_length = 0;
+/* Encodes the rest of the input, through io_uring for large inputs when available */
+static bool encodeRest(FILE *iFile, FILE *oFile, const EncodeOptions *options,
+		BlockIndex *index, BlockState *state) {
+	bool success = false;
+
+	if (encodeBlocksAsync(iFile, oFile, options, index, state, &success))
+		return success;
+
+	return encodeBlocks(iFile, oFile, options, index, state);
+}
+
+/* Function to Encode File*/
+bool encodeFile(char *in, char *out, const EncodeOptions *options) {
+	FILE *iFile = NULL;
+	FILE *oFile = NULL;
+	BlockIndex index;
+	BlockState state = { NULL };
+
+	if ((iFile = fopen(in, "rb")) == NULL)
+		return false;
 
-	char *bitstring = (char*) calloc(UINT_MAX, sizeof(char));
-	if (bitstring == NULL)
+	if ((oFile = fopen(out, "wb")) == NULL) {
+		fclose(iFile);
 		return false;
+	}
 
-	if ((file = fopen(inputFileName, "r")) != NULL) {
+	// write header, the blocks and then the index of the blocks
+	initializeIndex(&index);
+	fwrite(FILE_MAGIC, 1, MAGIC_SIZE, oFile);
+	bool success = encodeRest(iFile, oFile, options, &index, &state)
+			&& writeIndex(oFile, &index);
+	total_char_count = index.total;
 
-		if (getc(file) == EOF) { //empty file check
-			printf("<Empty File>\n");
-			fclose(file);
-			exit(0);
-		}
+#if DEBUG_MODE == 1
+	printf("\n");
+	printAnalysis();
+	printf("Generated Compressed File: %s\n", out);
+#endif
 
-		//retrieve the size of the txt and allocate memory for buffer
-		fseek(file, 0, SEEK_END);
-		txt_length = ftell(file);
-		txt_buffer = malloc(txt_length);
-		fseek(file, 0, SEEK_SET);
+	freeBlockState(&state);
+	freeIndex(&index);
+	fclose(iFile);
+	fclose(oFile);
+	return success;
+}
 
-		//read entire file to buffer
-		if (txt_buffer)
-			fread(txt_buffer, 1, txt_length, file);
+/* Puts back the index of a compressed file as it was before blocks were appended,
+ at its old offset, and cuts off anything written after it */
+static bool restoreIndex(FILE *oFile, BlockIndex *index, unsigned int count,
+		unsigned long long total, unsigned long long end) {
+	index->count = count;
+	index->total = total;
+
+	//the old index fits where it was, even when the disk is full
+	clearerr(oFile);
+	return fseek(oFile, end, SEEK_SET) == 0 && writeIndex(oFile, index)
+			&& fflush(oFile) == 0
+			&& ftruncate(fileno(oFile), ftell(oFile)) == 0;
+}
 
-		//close the file
-		fclose(file);
+/* Function to Append the new part of a grown file to its compressed file */
+bool appendFile(char *in, char *out, const EncodeOptions *options) {
+	FILE *iFile = NULL;
+	FILE *oFile = NULL;
+	BlockIndex index;
+	BlockState state = { NULL };
+
+	if ((oFile = fopen(out, "r+b")) == NULL)
+		return false;
+
+	if (!readIndex(oFile, &index)) {
+		fclose(oFile);
+		return false;
 	}
 
-	if ((file = fopen(outputFileName, "wb")) != NULL) {
-		// write header - total char count and unique char count
-		fwrite(&total_char_count, 1, sizeof(total_char_count), file);
-		fwrite(&unique_char_count, 1, sizeof(unique_char_count), file);
-
-		//write bit string length to header
-		for (int i = 0; txt_buffer[i] != '\0'; i++)
-			bit_len += strlen(char_encoding[(int) txt_buffer[i]]);
-		fwrite(&bit_len, 1, sizeof(bit_len), file);
-
-		//write the frequency table to file
-		for (int i = 0; i < MAX_CHARS; i++) {
-			if (char_count[i] > 0) {
-				fwrite(&i, 1, sizeof(char), file);
-				fwrite(&char_count[i], 1, sizeof(unsigned int), file);
-			}
+	//pick up the table of the last Huffman block, so new blocks can repeat it
+	for (unsigned int i = index.count; i-- > 0;) {
+		if (index.entries[i].type == BLOCK_HUFFMAN
+				|| index.entries[i].type == BLOCK_HUFFMAN16) {
+			if (fseek(oFile, index.entries[i].offset, SEEK_SET) == 0)
+				readBlockTable(oFile, &state);
+			break;
 		}
+	}
+
+	if ((iFile = fopen(in, "rb")) == NULL) {
+		freeBlockState(&state);
+		freeIndex(&index);
+		fclose(oFile);
+		return false;
+	}
 
-		// construct bitstring and process in 256 bit chunks
-		char *bitstring = (char*) calloc(UINT_MAX, sizeof(char));
-		for (int i = 0; txt_buffer[i] != '\0'; i++) {
+	//only the part of the input past what is already compressed is encoded
+	fseek(iFile, 0, SEEK_END);
+	long length = ftell(iFile);
+	bool success = length >= 0 && (unsigned long long) length >= index.total
+			&& fseek(iFile, index.total, SEEK_SET) == 0
+			&& fseek(oFile, index.end, SEEK_SET) == 0;
 
-			strcat(bitstring, char_encoding[(int ) txt_buffer[i]]);
+#if DEBUG_MODE == 1
+	printf("Appending %llu chars after %llu chars in %u blocks\n",
+			success ? length - index.total : 0, index.total, index.count);
+#endif
 
-			if (strlen(bitstring) >= BUFFER_LIMIT) {
+	//new blocks overwrite the old index, which is written again after them, or put
+	//back when appending fails, so the blocks compressed before stay readable
+	unsigned int old_count = index.count;
+	unsigned long long old_total = index.total;
+	unsigned long long old_end = index.end;
+	if (success) {
+		success = encodeRest(iFile, oFile, options, &index, &state)
+				&& writeIndex(oFile, &index) && fflush(oFile) == 0;
+		if (!success)
+			restoreIndex(oFile, &index, old_count, old_total, old_end);
+	}
+	total_char_count = index.total;
 
-				char *temp = (char*) calloc(UINT_MAX, sizeof(char));
+#if DEBUG_MODE == 1
+	printf("\n");
+	printAnalysis();
+	printf("Updated Compressed File: %s\n", out);
+#endif
 
-				stringSlice(bitstring, temp,
-						strlen(bitstring) - strlen(bitstring) % 8,
-						strlen(bitstring));
-				stringSlice(bitstring, bitstring, 0,
-						strlen(bitstring) - strlen(bitstring) % 8);
+	freeBlockState(&state);
+	freeIndex(&index);
+	fclose(iFile);
+	fclose(oFile);
+	return success;
+}
 
-				//write the Huffman encoding string to file
-				for (int k = 0; k < strlen(bitstring) - 7; k += 8) {
-					short int bin = 0;
-					for (int i = 0; i < 8; i++) {
-						if (bitstring[k + i] == '1')
-							bin += pow(2, (8 - i - 1));
-					}
+/* Parses a size in bytes, with an optional K, M or G suffix */
+bool parseSize(const char *text, size_t *size) {
+	char *end = NULL;
+	unsigned long long value = strtoull(text, &end, 10);
+	int shift = 0;
 
-					fwrite(&bin, 1, 1, file);
+	if (end == text || *text == '-')
+		return false;
+	switch (toupper((unsigned char) *end)) {
+	case 'G':
+		shift += 10;
+		/* fall through */
+	case 'M':
+		shift += 10;
+		/* fall through */
+	case 'K':
+		shift += 10;
+		end++;
+		break;
+	}
 
-				}
-				if (strlen(temp) > 0) {
+	//a trailing B is allowed, as in 64MB
+	if (toupper((unsigned char) *end) == 'B')
+		end++;
+	if (*end != '\0' || value == 0 || value > (SIZE_MAX >> shift))
+		return false;
 
-					strcpy(bitstring, temp);
-					free(temp);
-				} else {
-					bitstring = (char*) calloc(UINT_MAX, sizeof(char));
-				}
+	*size = (size_t) value << shift;
+	return true;
+}
 
-			}
-		}
+/* Fits the encoding options of an input file into a memory limit, 0 for no limit,
+ along with estimating it when that is what they are for */
+bool fitMemory(char *in, EncodeOptions *options, size_t limit,
+		bool estimating) {
+	FILE *iFile = NULL;
 
-		//write any leftovers bits
-		for (int k = 0; k < strlen(bitstring); k += 8) {
-			short int bin = 0;
-			for (int i = 0; i < 8; i++) {
-				if (bitstring[k + i] == '1')
-					bin += pow(2, (8 - i - 1));
-			}
-			fwrite(&bin, 1, 1, file);
-		}
+	if (limit == 0)
+		return true;
+	if ((iFile = fopen(in, "rb")) == NULL)
+		return false;
 
-		//close the file and clean up
-		fclose(file);
+	fseek(iFile, 0, SEEK_END);
+	long length = ftell(iFile);
+	fclose(iFile);
+	if (length < 0)
+		return false;
 
-	} else {
-		free(txt_buffer);
-		free(bitstring);
+	bool fits = estimating ?
+			limitEstimateMemory(options, limit, (unsigned long long) length) :
+			limitMemory(options, limit, (unsigned long long) length);
+	if (!fits) {
+		printf("ERROR: %s cannot be encoded within the memory limit.\n", in);
 		return false;
 	}
 
 #if DEBUG_MODE == 1
-	//binary string that is written to file
-//	printf("\nHuffman Binary Encoding of %s:\n", inputFileName);
-//	printf("%s\n", bitstring);
-	printf("Bits: %d\n", bit_len);
-	printf("Generated Compressed File: %s\n", outputFileName);
+	printf("Memory Limit: %zu bytes, %u byte blocks, %u in flight%s\n", limit,
+			options->block_size, options->queue_depth,
+			options->word_symbols ? ", byte pairs" : "");
 #endif
 
-	free(bitstring);
-	free(txt_buffer);
 	return true;
-
 }
 
-/* Function that retrieves the binary string of any given char in the tree */
-void getCharEncoding(TNode *node, char *str) {
-	if (node == NULL)
-		return;
+/* Function to Estimate the compression of a File without encoding it */
+bool reportEstimate(char *in, const EncodeOptions *options) {
+	FILE *iFile = NULL;
+	Estimate estimate;
+
+	if ((iFile = fopen(in, "rb")) == NULL)
+		return false;
 
-	if (node->left == NULL && node->right == NULL) {
-		_getCharEncoding(node, node, str);
-	} else {
-		getCharEncoding(node->left, str);
-		getCharEncoding(node->right, str);
-	}
-}
+	bool success = estimateFile(iFile, options, &estimate);
+	fclose(iFile);
+	if (!success)
+		return false;
 
-/* Auxiliary Function for getCharEncoding */
-void _getCharEncoding(TNode *node, TNode *next_node, char *str) {
-	if (next_node->parent != NULL) {
-		if (next_node == next_node->parent->left)
-			prependStr(str, "0");
-		if (next_node == next_node->parent->right)
-			prependStr(str, "1");
-		_getCharEncoding(node, next_node->parent, str);
-	} else {
-		strcpy(char_encoding[(int )node->symbol], str);
-		strcpy(str, "");
-	}
+	printf("ESTIMATE[%s]\n", in);
+	printf("Total Characters: %llu\n", estimate.total);
+	if (estimate.sampled < estimate.total)
+		printf("Sampled Characters: %llu\n", estimate.sampled);
+	printf("Unique Characters: %u\n", estimate.unique);
+	printf("Symbols: %s\n", estimate.word_symbols ? "byte pairs" : "characters");
+	printf("Entropy: %.4f bits/char\n", estimate.entropy);
+	printf("Shannon Bound: %llu bytes\n", estimate.shannon_size);
+	if (estimate.huffman_size != ULLONG_MAX)
+		printf("Huffman Size: %llu bytes\n", estimate.huffman_size);
+	printf("Estimated Output: %llu bytes (%.1f%%)\n", estimate.encoded_size,
+			estimate.total > 0 ?
+					100.0 * estimate.encoded_size / estimate.total : 100.0);
+	printf("COMPRESSION %s\n",
+			estimate.compressible ? "RECOMMENDED" : "NOT RECOMMENDED");
+
+	return true;
 }
 
 /* Prints the Constructed Huffman Tree */
@@ -495,8 +868,8 @@ void printBT(BT *bt) {
 			j = 1;
 		}
 		printf("(%-2c - %2d)\t",
-				node->symbol == '\0' ? '_' :
-				node->symbol == '\n' ? '*' : node->symbol, node->weight);
+				node->left != NULL ? '_' :
+				isprint(node->symbol) ? node->symbol : '*', node->weight);
 		j++;
 	}
 	printf("\n");
@@ -534,71 +907,33 @@ int pQTest() {
 	return 0;
 }
 
-/* File Analysis Function */
-void analyse_file() {
-	FILE *file = NULL;
-	char *txt_buffer = 0;
-	unsigned long txt_length = 0;
-
-	if ((file = fopen(inputFileName, "r")) != NULL) {
-
-		if (getc(file) == EOF) { //empty file check
-			printf("<Empty File>\n");
-			fclose(file);
-			exit(0);
-		}
-
-		//retrieve the size of the txt and allocate memory for buffer
-		fseek(file, 0, SEEK_END);
-		txt_length = ftell(file);
-		txt_buffer = malloc(txt_length);
-		fseek(file, 0, SEEK_SET);
-
-		//read entire file to buffer
-		if (txt_buffer)
-			fread(txt_buffer, 1, txt_length, file);
-
-		//close the file
-		fclose(file);
-
-		getCharCounts(txt_buffer);
-	}
-}
-
 /* Prints the results of File Analysis */
 void printAnalysis() {
 	printf("----PRINT ANALYSIS----\n");
-	for (int i = 0, j = 1; char_list[i] != '\0'; i++, j++) {
+	for (int i = 0, j = 1; i < unique_char_count; i++, j++) {
 		if (j > 10) {
 			printf("\n");
 			j = 1;
 		}
-		printf("[%c:%d]\t", char_list[i] == '\n' ? '|' : char_list[i],
-				char_count[(int) char_list[i]]);
+		printf("[%c:%d]\t", isprint(char_list[i]) ? char_list[i] : '|',
+				char_count[char_list[i]]);
 	}
 	printf("\n");
-	printf("Total Characters: %d\n", total_char_count);
+	printf("Total Characters: %llu\n", total_char_count);
 	printf("Unique Characters: %d\n", unique_char_count);
 }
 
-/* Retrieves relevant information for the construction of the Huffman Tree */
-void getCharCounts(char *msg) {
-
-	for (int i = 0; msg[i] != '\0'; i++) {
-		//check and add character to char list
-		total_char_count++;
-		for (int k = 0; k < MAX_CHARS; k++) {
-			// character already in char list, skip
-			if (char_list[k] == msg[i])
-				break;
-			// character not found in char list, so add it
-			if (char_list[k] == 0) {
-				char_list[k] = msg[i];
-				unique_char_count++;
-				break;
-			}
-		}
+/* Retrieves the character statistics printed by the File Analysis */
+void getCharCounts(char *msg, size_t len) {
+
+	for (size_t i = 0; i < len; i++) {
+		unsigned char c = (unsigned char) msg[i];
+
+		// character not found in char list, so add it
+		if (char_count[c] == 0)
+			char_list[unique_char_count++] = c;
+
 		//increment or initialize char count of the character
-		char_count[(int) msg[i]]++;
+		char_count[c]++;
 	}
 }
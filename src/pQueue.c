@@ -4,7 +4,7 @@
  Project: Huffman TXT Compressor
  -------------------------------------
  Author:	Roy Ceyleon
- Version:	2020-11-20
+ Version:	2026-10-19
  -------------------------------------
  */
 
@@ -18,12 +18,15 @@
 PriorityQueue* createPQueue() {
 	PriorityQueue *pQ = (PriorityQueue*) malloc(sizeof(PriorityQueue));
 	pQ->front = NULL;
+	pQ->size = 0;
 	return pQ;
 }
 
 Queue* createQueue() {
 	Queue *Q = (Queue*) malloc(sizeof(Queue));
 	Q->front = NULL;
+	Q->rear = NULL;
+	Q->size = 0;
 	return Q;
 }
 
@@ -62,8 +65,6 @@ void enqueuePQueue(PriorityQueue *pQ, TNode *node) {
 
 void enqueueQueue(Queue *Q, TNode *node) {
 	QNode *new_node = (QNode*) malloc(sizeof(QNode));
-	QNode *ptr = NULL;
-	QNode *prev_ptr = NULL;
 
 	new_node->data = node;
 	new_node->next = NULL;
@@ -71,16 +72,9 @@ void enqueueQueue(Queue *Q, TNode *node) {
 	if (Q->front == NULL) {
 		Q->front = new_node;
 	} else {
-		ptr = Q->front;
-
-		while (ptr != NULL) {
-			prev_ptr = ptr;
-			ptr = ptr->next;
-		}
-
-		new_node->next = ptr;
-		prev_ptr->next = new_node;
+		Q->rear->next = new_node;
 	}
+	Q->rear = new_node;
 
 	Q->size++;
 
@@ -110,6 +104,8 @@ TNode* dequeueQueue(Queue *Q) {
 	QNode *temp = Q->front;
 	TNode *node = Q->front->data;
 	Q->front = Q->front->next;
+	if (Q->front == NULL)
+		Q->rear = NULL;
 	Q->size--;
 	free(temp);
 
@@ -4,7 +4,7 @@
  Project: Huffman TXT Compressor
  -------------------------------------
  Author: Roy Ceyleon
- Version: 2020-11-20
+ Version: 2026-10-19
  -------------------------------------
  */
 
@@ -23,6 +23,7 @@ typedef struct PriorityQueue {
 
 typedef struct Queue {
 	QNode *front;
+	QNode *rear;
 	int size;
 } Queue;
 
@@ -0,0 +1,297 @@
+/*
+ -------------------------------------
+ File:    table.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "table.h"
+
+/* Creates an empty code table for an alphabet of the given size */
+HuffTable* createTable(int symbols) {
+	HuffTable *table = (HuffTable*) calloc(1, sizeof(HuffTable));
+	if (table == NULL)
+		return NULL;
+
+	table->symbols = symbols;
+	atomic_init(&table->refs, 1);
+	table->lens = (unsigned char*) calloc(symbols, sizeof(unsigned char));
+	if (table->lens == NULL) {
+		free(table);
+		return NULL;
+	}
+
+	return table;
+}
+
+/* Releases a reference to a code table, freeing it with the last one */
+void freeTable(HuffTable *table) {
+	if (table == NULL || atomic_fetch_sub(&table->refs, 1) > 1)
+		return;
+
+	free(table->lens);
+	free(table->codes);
+	free(table->lookup);
+	free(table->sorted);
+	free(table);
+}
+
+/* Lays out the canonical code from the code lengths, rejects incomplete codes */
+static bool layoutCodes(HuffTable *table) {
+	unsigned long long kraft = 0;
+	unsigned int code = 0;
+
+	memset(table->count, 0, sizeof(table->count));
+	for (int i = 0; i < table->symbols; i++) {
+		if (table->lens[i] > MAX_CODE_LEN)
+			return false;
+		if (table->lens[i] > 0) {
+			table->count[table->lens[i]]++;
+			kraft += 1ULL << (MAX_CODE_LEN - table->lens[i]);
+		}
+	}
+
+	//every bit sequence has to lead to a symbol, or decoding could run off
+	if (kraft != 1ULL << MAX_CODE_LEN)
+		return false;
+
+	table->count[0] = 0;
+	table->offset[0] = 0;
+	table->max_len = 0;
+	for (int len = 1; len <= MAX_CODE_LEN; len++) {
+		code = (code + table->count[len - 1]) << 1;
+		table->first[len] = code;
+		table->offset[len] = table->offset[len - 1] + table->count[len - 1];
+		if (table->count[len] > 0)
+			table->max_len = len;
+	}
+
+	return true;
+}
+
+/* Assigns the canonical code of every symbol, for encoding */
+bool buildEncodeTable(HuffTable *table) {
+	unsigned int next[MAX_CODE_LEN + 1];
+
+	if (!layoutCodes(table))
+		return false;
+
+	if (table->codes == NULL
+			&& (table->codes = (HuffCode*) malloc(
+					table->symbols * sizeof(HuffCode))) == NULL)
+		return false;
+
+	memcpy(next, table->first, sizeof(next));
+	for (int i = 0; i < table->symbols; i++) {
+		table->codes[i].len = table->lens[i];
+		table->codes[i].bits = table->lens[i] > 0 ? next[table->lens[i]]++ : 0;
+	}
+
+	return true;
+}
+
+/* Builds the lookup table and canonical symbol order, for decoding */
+bool buildDecodeTable(HuffTable *table) {
+	unsigned int next[MAX_CODE_LEN + 1];
+
+	if (!layoutCodes(table))
+		return false;
+
+	table->lookup_bits = table->symbols > 256 ? LOOKUP_BITS_16 : LOOKUP_BITS_8;
+
+	if (table->sorted == NULL
+			&& (table->sorted = (unsigned short*) malloc(
+					table->symbols * sizeof(unsigned short))) == NULL)
+		return false;
+	if (table->lookup == NULL
+			&& (table->lookup = (DecodeEntry*) malloc(
+					(1 << table->lookup_bits) * sizeof(DecodeEntry))) == NULL)
+		return false;
+
+	//entries left at length 0 belong to codes longer than the lookup
+	memset(table->lookup, 0, (1 << table->lookup_bits) * sizeof(DecodeEntry));
+
+	memcpy(next, table->first, sizeof(next));
+	for (int i = 0; i < table->symbols; i++) {
+		int len = table->lens[i];
+		if (len == 0)
+			continue;
+
+		unsigned int code = next[len]++;
+		table->sorted[table->offset[len] + code - table->first[len]] =
+				(unsigned short) i;
+
+		//every lookup index starting with this code resolves to the symbol
+		if (len <= table->lookup_bits) {
+			int shift = table->lookup_bits - len;
+			for (unsigned int k = 0; k < (1U << shift); k++) {
+				table->lookup[(code << shift) | k].symbol = (unsigned short) i;
+				table->lookup[(code << shift) | k].len = (unsigned char) len;
+			}
+		}
+	}
+
+	return true;
+}
+
+/* Returns the exact number of bits needed to encode the given symbol counts */
+unsigned long long getEncodedBits(const HuffTable *table,
+		const unsigned int *counts) {
+	unsigned long long bits = 0;
+	for (int i = 0; i < table->symbols; i++)
+		bits += (unsigned long long) counts[i] * table->lens[i];
+	return bits;
+}
+
+typedef struct CacheEntry {
+	HuffTable *table;
+	unsigned long long hash;	//of the code lengths
+	unsigned long long last_use;
+	size_t bytes;
+} CacheEntry;
+
+//Tables shared by every block, file and thread, looked up by their code lengths
+static CacheEntry cache[TABLE_CACHE_SIZE];
+static size_t cache_bytes = 0;
+static size_t cache_limit = TABLE_CACHE_BYTES;
+static unsigned long long cache_clock = 0;
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Returns the FNV-1a hash of the code lengths of a table */
+static unsigned long long hashLengths(const HuffTable *table) {
+	unsigned long long hash = 14695981039346656037ULL ^ table->symbols;
+	for (int i = 0; i < table->symbols; i++)
+		hash = (hash ^ table->lens[i]) * 1099511628211ULL;
+	return hash;
+}
+
+/* Returns the memory held by a table of an alphabet with both its encode and decode parts */
+size_t getTableBytes(int symbols) {
+	int lookup_bits = symbols > 256 ? LOOKUP_BITS_16 : LOOKUP_BITS_8;
+	return sizeof(HuffTable)
+			+ symbols
+					* (sizeof(unsigned char) + sizeof(HuffCode)
+							+ sizeof(unsigned short))
+			+ ((size_t) 1 << lookup_bits) * sizeof(DecodeEntry);
+}
+
+/* Finds a cached table with the same code lengths and takes a reference to it,
+ the cache has to be locked */
+static HuffTable* findCached(const HuffTable *table, unsigned long long hash) {
+	for (int i = 0; i < TABLE_CACHE_SIZE; i++) {
+		HuffTable *cached = cache[i].table;
+		if (cached != NULL && cache[i].hash == hash
+				&& cached->symbols == table->symbols
+				&& memcmp(cached->lens, table->lens, table->symbols) == 0) {
+			cache[i].last_use = ++cache_clock;
+			atomic_fetch_add(&cached->refs, 1);
+			return cached;
+		}
+	}
+	return NULL;
+}
+
+/* Drops the least recently used table from the cache, the cache has to be locked */
+static void evictCached(void) {
+	int lru = -1;
+	for (int i = 0; i < TABLE_CACHE_SIZE; i++)
+		if (cache[i].table != NULL
+				&& (lru < 0 || cache[i].last_use < cache[lru].last_use))
+			lru = i;
+
+	//blocks still coding with the table keep it alive
+	if (lru >= 0) {
+		freeTable(cache[lru].table);
+		cache_bytes -= cache[lru].bytes;
+		cache[lru].table = NULL;
+	}
+}
+
+/* Adds a table to the cache, the cache has to be locked */
+static void addCached(HuffTable *table, unsigned long long hash) {
+	size_t bytes = getTableBytes(table->symbols);
+	int slot = -1;
+
+	if (bytes > cache_limit)
+		return;
+
+	while (cache_bytes + bytes > cache_limit)
+		evictCached();
+	for (int i = 0; slot < 0 && i < TABLE_CACHE_SIZE; i++)
+		if (cache[i].table == NULL)
+			slot = i;
+	if (slot < 0) {
+		evictCached();
+		for (int i = 0; slot < 0 && i < TABLE_CACHE_SIZE; i++)
+			if (cache[i].table == NULL)
+				slot = i;
+	}
+
+	atomic_fetch_add(&table->refs, 1);
+	cache[slot].table = table;
+	cache[slot].hash = hash;
+	cache[slot].last_use = ++cache_clock;
+	cache[slot].bytes = bytes;
+	cache_bytes += bytes;
+}
+
+/* Trades a table holding only code lengths for a shared one, ready to encode and
+ decode, with the same lengths. The given table is released either way. Returns
+ NULL when the lengths do not form a complete code. Shared tables are read only */
+HuffTable* shareTable(HuffTable *table) {
+	unsigned long long hash = hashLengths(table);
+	HuffTable *cached = NULL;
+
+	pthread_mutex_lock(&cache_lock);
+	cached = findCached(table, hash);
+	pthread_mutex_unlock(&cache_lock);
+	if (cached != NULL) {
+		freeTable(table);
+		return cached;
+	}
+
+	//tables are built outside the lock, so a missing one does not hold up others
+	if (!buildEncodeTable(table) || !buildDecodeTable(table)) {
+		freeTable(table);
+		return NULL;
+	}
+
+	//another thread may have cached the same lengths meanwhile
+	pthread_mutex_lock(&cache_lock);
+	if ((cached = findCached(table, hash)) == NULL)
+		addCached(table, hash);
+	pthread_mutex_unlock(&cache_lock);
+	if (cached != NULL) {
+		freeTable(table);
+		return cached;
+	}
+
+	return table;
+}
+
+/* Empties the table cache, tables still in use are freed once released */
+void clearTableCache(void) {
+	pthread_mutex_lock(&cache_lock);
+	while (cache_bytes > 0)
+		evictCached();
+	pthread_mutex_unlock(&cache_lock);
+}
+
+/* Sets the memory the table cache may hold, dropping the least recently used tables
+ that no longer fit */
+void setTableCacheBytes(size_t bytes) {
+	pthread_mutex_lock(&cache_lock);
+	cache_limit = bytes;
+	while (cache_bytes > cache_limit)
+		evictCached();
+	pthread_mutex_unlock(&cache_lock);
+}
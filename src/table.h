@@ -0,0 +1,60 @@
+/*
+ -------------------------------------
+ File:    table.h
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#ifndef TABLE_H_
+#define TABLE_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define MAX_CODE_LEN	24	//longest code the encoder emits and the decoder accepts
+#define LOOKUP_BITS_8	12	//bits resolved per lookup for byte alphabets
+#define LOOKUP_BITS_16	14	//bits resolved per lookup for 16-bit alphabets
+#define SHORT_CODE_LEN	12	//longest code of the fast levels, one byte lookup decodes any of them
+#define TABLE_CACHE_SIZE	64	//shared tables kept for later blocks and files
+#define TABLE_CACHE_BYTES	(16 << 20)	//memory the shared tables may hold, unless set lower
+
+typedef struct HuffCode {
+	unsigned int bits;
+	unsigned char len;
+} HuffCode;
+
+typedef struct DecodeEntry {
+	unsigned short symbol;
+	unsigned char len;	//0 - code is longer than the lookup, decode it canonically
+} DecodeEntry;
+
+typedef struct HuffTable {
+	int symbols;		//size of the alphabet (256 or 65536)
+	unsigned char *lens;	//code length of every symbol, 0 when unused
+	HuffCode *codes;	//canonical code of every symbol
+	int max_len;		//longest code in the table
+	int lookup_bits;
+	DecodeEntry *lookup;	//first level decode table
+	unsigned int count[MAX_CODE_LEN + 1];	//number of codes of each length
+	unsigned int first[MAX_CODE_LEN + 1];	//first canonical code of each length
+	unsigned int offset[MAX_CODE_LEN + 1];	//index of that code in sorted
+	unsigned short *sorted;	//symbols in canonical order
+	atomic_int refs;	//owners of the table, the cache is one while it holds it
+} HuffTable;
+
+HuffTable* createTable(int symbols);
+void freeTable(HuffTable *table);
+bool buildEncodeTable(HuffTable *table);
+bool buildDecodeTable(HuffTable *table);
+unsigned long long getEncodedBits(const HuffTable *table,
+		const unsigned int *counts);
+size_t getTableBytes(int symbols);
+HuffTable* shareTable(HuffTable *table);
+void clearTableCache(void);
+void setTableCacheBytes(size_t bytes);
+
+#endif /* TABLE_H_ */
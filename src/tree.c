@@ -4,7 +4,7 @@
  Project: Huffman TXT Compressor
  -------------------------------------
  Author:	Roy Ceyleon
- Version:	2020-11-20
+ Version:	2026-10-19
  -------------------------------------
  */
 
@@ -37,3 +37,175 @@ void initializeBT(BT *bt, TNode *root_node) {
 	}
 
 }
+
+/* Orders leaves by weight, then by symbol so every build is identical */
+static int compareLeaves(const void *a, const void *b) {
+	const TNode *n1 = *(const TNode**) a;
+	const TNode *n2 = *(const TNode**) b;
+	if (n1->weight != n2->weight)
+		return n1->weight < n2->weight ? -1 : 1;
+	return n1->symbol - n2->symbol;
+}
+
+/* Takes the lighter of the two queue fronts */
+static TNode* dequeueLightest(Queue *leaves, Queue *nodes) {
+	if (nodes->front == NULL)
+		return dequeueQueue(leaves);
+	if (leaves->front == NULL)
+		return dequeueQueue(nodes);
+	if (leaves->front->data->weight <= nodes->front->data->weight)
+		return dequeueQueue(leaves);
+	return dequeueQueue(nodes);
+}
+
+/* Builds a Huffman Tree from a frequency table of n symbols */
+TNode* buildHuffmanTree(const unsigned int *counts, int n) {
+	TNode **sorted = (TNode**) malloc(n * sizeof(TNode*));
+	int k = 0;
+
+	//Create tree nodes with symbols and their respective weights
+	for (int i = 0; i < n; i++) {
+		if (counts[i] > 0) {
+			TNode *new_node = (TNode*) malloc(sizeof(TNode));
+			new_node->parent = NULL;
+			new_node->left = NULL;
+			new_node->right = NULL;
+			new_node->symbol = i;
+			new_node->weight = counts[i];
+			sorted[k++] = new_node;
+		}
+	}
+
+	//Sorted leaves and merged nodes each come out of their queue in weight order,
+	//so the two lightest nodes are always at the fronts
+	qsort(sorted, k, sizeof(TNode*), compareLeaves);
+	Queue *leaves = createQueue();
+	Queue *nodes = createQueue();
+	for (int i = 0; i < k; i++)
+		enqueueQueue(leaves, sorted[i]);
+	free(sorted);
+
+	//Build Huffman Tree
+	while (leaves->size + nodes->size > 1) {
+		TNode *n1 = dequeueLightest(leaves, nodes);
+		TNode *n2 = dequeueLightest(leaves, nodes);
+		TNode *new_node = (TNode*) malloc(sizeof(TNode));
+		new_node->parent = NULL;
+		new_node->left = n1;
+		new_node->right = n2;
+		n1->parent = new_node;
+		n2->parent = new_node;
+		new_node->weight = n1->weight + n2->weight;
+		new_node->symbol = 0;
+		enqueueQueue(nodes, new_node);
+	}
+
+	TNode *root = dequeueLightest(leaves, nodes);
+	free(leaves);
+	free(nodes);
+	return root;
+}
+
+/* Records the depth of every leaf below the given node, returns the deepest */
+static int getDepths(TNode *node, unsigned char *lens, int depth) {
+	if (node == NULL)
+		return 0;
+
+	if (node->left == NULL && node->right == NULL) {
+		lens[node->symbol] = (unsigned char) depth;
+		return depth;
+	}
+
+	int left = getDepths(node->left, lens, depth + 1);
+	int right = getDepths(node->right, lens, depth + 1);
+	return left > right ? left : right;
+}
+
+typedef struct Leaf {
+	unsigned int count;
+	int symbol;
+} Leaf;
+
+/* Orders leaves from the most to the least frequent, then by symbol */
+static int compareCounts(const void *a, const void *b) {
+	const Leaf *l1 = (const Leaf*) a;
+	const Leaf *l2 = (const Leaf*) b;
+	if (l1->count != l2->count)
+		return l1->count > l2->count ? -1 : 1;
+	return l1->symbol - l2->symbol;
+}
+
+/* Cuts lengths deeper than max_len down to it, then moves leaves one level down, each
+ taking a cut leaf as its sibling, until the lengths form a complete code again. The
+ shortest lengths go back to the most frequent symbols */
+static void limitLengths(const unsigned int *counts, int n, unsigned char *lens,
+		int max_len) {
+	unsigned int bl_count[256] = { 0 };
+	unsigned long long kraft = 0;
+	int k = 0;
+
+	for (int i = 0; i < n; i++) {
+		if (lens[i] > 0) {
+			int len = lens[i] < max_len ? lens[i] : max_len;
+			bl_count[len]++;
+			kraft += 1ULL << (max_len - len);
+			k++;
+		}
+	}
+
+	//every move takes one unit off the code space
+	while (kraft > 1ULL << max_len) {
+		int bits = max_len - 1;
+		while (bl_count[bits] == 0)
+			bits--;
+		bl_count[bits]--;
+		bl_count[bits + 1] += 2;
+		bl_count[max_len]--;
+		kraft--;
+	}
+
+	//without the order the lengths are left out, so no table is built from them
+	Leaf *leaves = (Leaf*) malloc(k * sizeof(Leaf));
+	if (leaves == NULL) {
+		memset(lens, 0, n);
+		return;
+	}
+
+	k = 0;
+	for (int i = 0; i < n; i++) {
+		if (lens[i] > 0) {
+			leaves[k].count = counts[i];
+			leaves[k++].symbol = i;
+		}
+	}
+	qsort(leaves, k, sizeof(Leaf), compareCounts);
+
+	for (int len = 1, j = 0; len <= max_len; len++)
+		for (unsigned int c = 0; c < bl_count[len]; c++)
+			lens[leaves[j++].symbol] = (unsigned char) len;
+
+	free(leaves);
+}
+
+/* Function that retrieves the code length of every symbol, limited to max_len bits,
+ which has to leave room for every symbol */
+void getCodeLengths(const unsigned int *counts, int n, unsigned char *lens,
+		int max_len) {
+	TNode *root = buildHuffmanTree(counts, n);
+	memset(lens, 0, n);
+	int depth = getDepths(root, lens, 0);
+	freeTree(root);
+
+	if (depth > max_len)
+		limitLengths(counts, n, lens, max_len);
+}
+
+/* Releases every node of a tree */
+void freeTree(TNode *node) {
+	if (node == NULL)
+		return;
+
+	freeTree(node->left);
+	freeTree(node->right);
+	free(node);
+}
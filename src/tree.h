@@ -4,7 +4,7 @@
  Project: Huffman TXT Compressor
  -------------------------------------
  Author(s):	Roy Ceyleon
- Version:	2020-11-20
+ Version:	2026-10-19
  -------------------------------------
  */
 
@@ -15,7 +15,7 @@ typedef struct TNode {
 	struct TNode *parent;
 	struct TNode *left;
 	struct TNode *right;
-	char symbol;
+	int symbol;
 	int weight;
 } TNode;
 
@@ -25,5 +25,9 @@ typedef struct BT {
 } BT;
 
 void initializeBT(BT *bt, TNode *root_node);
+TNode* buildHuffmanTree(const unsigned int *counts, int n);
+void getCodeLengths(const unsigned int *counts, int n, unsigned char *lens,
+		int max_len);
+void freeTree(TNode *node);
 
 #endif /* TREE_H_ */
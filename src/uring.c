@@ -0,0 +1,269 @@
+/*
+ -------------------------------------
+ File:    uring.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ Minimal io_uring wrapper on top of the raw system calls. On systems without
+ io_uring, or when the kernel refuses to set up a ring, createRing returns NULL
+ and callers fall back to blocking stdio.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "uring.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define HAVE_IO_URING 1
+#endif
+#endif
+
+#ifdef HAVE_IO_URING
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+struct Ring {
+	int fd;
+	unsigned int entries;
+	bool fixed;	//buffers are registered with the kernel
+	unsigned int queued;	//entries filled in but not yet submitted
+
+	unsigned int *sq_head;
+	unsigned int *sq_tail;
+	unsigned int *sq_mask;
+	unsigned int *sq_array;
+	struct io_uring_sqe *sqes;
+
+	unsigned int *cq_head;
+	unsigned int *cq_tail;
+	unsigned int *cq_mask;
+	struct io_uring_cqe *cqes;
+
+	void *sq_ring;
+	size_t sq_ring_size;
+	void *cq_ring;
+	size_t cq_ring_size;
+	size_t sqes_size;
+};
+
+/* Sets up a ring for the given number of requests and registers the buffers */
+Ring* createRing(unsigned int entries, void **buffers, const size_t *sizes,
+		unsigned int count) {
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+
+	int fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+	if (fd < 0)
+		return NULL;
+
+	Ring *ring = (Ring*) calloc(1, sizeof(Ring));
+	if (ring == NULL) {
+		close(fd);
+		return NULL;
+	}
+	ring->fd = fd;
+	ring->entries = params.sq_entries;
+	ring->sq_ring = MAP_FAILED;
+	ring->cq_ring = MAP_FAILED;
+	ring->sqes = MAP_FAILED;
+
+	//map the submission and completion rings, a single mapping on newer kernels
+	ring->sq_ring_size = params.sq_off.array
+			+ params.sq_entries * sizeof(unsigned int);
+	ring->cq_ring_size = params.cq_off.cqes
+			+ params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		if (ring->cq_ring_size > ring->sq_ring_size)
+			ring->sq_ring_size = ring->cq_ring_size;
+		ring->cq_ring_size = ring->sq_ring_size;
+	}
+
+	ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	if (ring->sq_ring == MAP_FAILED) {
+		freeRing(ring);
+		return NULL;
+	}
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+		ring->cq_ring = ring->sq_ring;
+	else
+		ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+
+	ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = (struct io_uring_sqe*) mmap(NULL, ring->sqes_size,
+			PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+			IORING_OFF_SQES);
+	if (ring->cq_ring == MAP_FAILED || ring->sqes == MAP_FAILED) {
+		freeRing(ring);
+		return NULL;
+	}
+
+	char *sq = (char*) ring->sq_ring;
+	char *cq = (char*) ring->cq_ring;
+	ring->sq_head = (unsigned int*) (sq + params.sq_off.head);
+	ring->sq_tail = (unsigned int*) (sq + params.sq_off.tail);
+	ring->sq_mask = (unsigned int*) (sq + params.sq_off.ring_mask);
+	ring->sq_array = (unsigned int*) (sq + params.sq_off.array);
+	ring->cq_head = (unsigned int*) (cq + params.cq_off.head);
+	ring->cq_tail = (unsigned int*) (cq + params.cq_off.tail);
+	ring->cq_mask = (unsigned int*) (cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe*) (cq + params.cq_off.cqes);
+
+	//registered buffers are mapped once instead of on every request, plain
+	//requests still work when registering fails (e.g. a low RLIMIT_MEMLOCK)
+	struct iovec *iov = (struct iovec*) malloc(count * sizeof(struct iovec));
+	if (iov != NULL) {
+		for (unsigned int i = 0; i < count; i++) {
+			iov[i].iov_base = buffers[i];
+			iov[i].iov_len = sizes[i];
+		}
+		ring->fixed = syscall(__NR_io_uring_register, fd,
+				IORING_REGISTER_BUFFERS, iov, count) == 0;
+		free(iov);
+	}
+
+	return ring;
+}
+
+/* Tears down a ring, waiting requests are cancelled by the kernel */
+void freeRing(Ring *ring) {
+	if (ring == NULL)
+		return;
+
+	if (ring->sqes != MAP_FAILED)
+		munmap(ring->sqes, ring->sqes_size);
+	if (ring->cq_ring != MAP_FAILED && ring->cq_ring != ring->sq_ring)
+		munmap(ring->cq_ring, ring->cq_ring_size);
+	if (ring->sq_ring != MAP_FAILED)
+		munmap(ring->sq_ring, ring->sq_ring_size);
+	close(ring->fd);
+	free(ring);
+}
+
+/* Fills in the next submission entry */
+static bool queueRequest(Ring *ring, int opcode, int fixed_opcode, int fd,
+		unsigned int buffer, const void *data, unsigned int len,
+		unsigned long long offset, unsigned long long tag) {
+	unsigned int tail = *ring->sq_tail;
+	unsigned int head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+
+	if (tail - head >= ring->entries)
+		return false;
+
+	unsigned int slot = tail & *ring->sq_mask;
+	struct io_uring_sqe *sqe = &ring->sqes[slot];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = (unsigned char) (ring->fixed ? fixed_opcode : opcode);
+	sqe->fd = fd;
+	sqe->addr = (unsigned long long) (size_t) data;
+	sqe->len = len;
+	sqe->off = offset;
+	sqe->user_data = tag;
+	if (ring->fixed)
+		sqe->buf_index = (unsigned short) buffer;
+
+	ring->sq_array[slot] = slot;
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	ring->queued++;
+
+	return true;
+}
+
+/* Queues a read of len bytes at offset into one of the registered buffers */
+bool queueRead(Ring *ring, int fd, unsigned int buffer, void *data,
+		unsigned int len, unsigned long long offset, unsigned long long tag) {
+	return queueRequest(ring, IORING_OP_READ, IORING_OP_READ_FIXED, fd, buffer,
+			data, len, offset, tag);
+}
+
+/* Queues a write of len bytes at offset from one of the registered buffers */
+bool queueWrite(Ring *ring, int fd, unsigned int buffer, const void *data,
+		unsigned int len, unsigned long long offset, unsigned long long tag) {
+	return queueRequest(ring, IORING_OP_WRITE, IORING_OP_WRITE_FIXED, fd,
+			buffer, data, len, offset, tag);
+}
+
+/* Hands the queued requests to the kernel, waiting for min_complete of them */
+static bool enterRing(Ring *ring, unsigned int min_complete) {
+	for (;;) {
+		int submitted = (int) syscall(__NR_io_uring_enter, ring->fd,
+				ring->queued, min_complete,
+				min_complete > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+		if (submitted >= 0) {
+			ring->queued -= submitted;
+			return true;
+		}
+		if (errno != EINTR)
+			return false;
+	}
+}
+
+/* Hands the queued requests to the kernel without waiting */
+bool submitRing(Ring *ring) {
+	return ring->queued == 0 || enterRing(ring, 0);
+}
+
+/* Waits for the next completed request, returning its tag and result */
+bool waitRing(Ring *ring, unsigned long long *tag, int *result) {
+	for (;;) {
+		unsigned int head = *ring->cq_head;
+		if (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+			struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+			*tag = cqe->user_data;
+			*result = cqe->res;
+			__atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+			return true;
+		}
+
+		if (!enterRing(ring, 1))
+			return false;
+	}
+}
+
+#else
+
+struct Ring {
+	int unused;
+};
+
+/* io_uring is not available, callers use blocking I/O instead */
+Ring* createRing(unsigned int entries, void **buffers, const size_t *sizes,
+		unsigned int count) {
+	return NULL;
+}
+
+void freeRing(Ring *ring) {
+}
+
+bool queueRead(Ring *ring, int fd, unsigned int buffer, void *data,
+		unsigned int len, unsigned long long offset, unsigned long long tag) {
+	return false;
+}
+
+bool queueWrite(Ring *ring, int fd, unsigned int buffer, const void *data,
+		unsigned int len, unsigned long long offset, unsigned long long tag) {
+	return false;
+}
+
+bool submitRing(Ring *ring) {
+	return false;
+}
+
+bool waitRing(Ring *ring, unsigned long long *tag, int *result) {
+	return false;
+}
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ -------------------------------------
+ File:    uring.h
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#ifndef URING_H_
+#define URING_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct Ring Ring;
+
+Ring* createRing(unsigned int entries, void **buffers, const size_t *sizes,
+		unsigned int count);
+void freeRing(Ring *ring);
+bool queueRead(Ring *ring, int fd, unsigned int buffer, void *data,
+		unsigned int len, unsigned long long offset, unsigned long long tag);
+bool queueWrite(Ring *ring, int fd, unsigned int buffer, const void *data,
+		unsigned int len, unsigned long long offset, unsigned long long tag);
+bool submitRing(Ring *ring);
+bool waitRing(Ring *ring, unsigned long long *tag, int *result);
+
+#endif /* URING_H_ */
@@ -0,0 +1,68 @@
+/*
+ -------------------------------------
+ File:    fuzz_decode.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+
+ Decodes any input as a stream of blocks with decodeBlock(), then as a compressed file
+ with readIndex() and decodeBlocks(). Neither may crash, read out of bounds or leak,
+ whatever the input.
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "block.h"
+#include "container.h"
+
+#define FUZZ_MAX_TOTAL	(1 << 24)	//largest decoded file an input may ask for
+
+static unsigned char block[MAX_BLOCK_SIZE];
+
+/* Decodes blocks back to back until one does not decode */
+static void decodeStream(const uint8_t *data, size_t size) {
+	FILE *file = fmemopen((void*) data, size, "rb");
+	BlockState state = { NULL };
+	unsigned int len = 0;
+	BlockType type;
+
+	if (file == NULL)
+		return;
+	while (decodeBlock(file, block, MAX_BLOCK_SIZE, &state, &len, &type))
+		;
+
+	freeBlockState(&state);
+	fclose(file);
+}
+
+/* Decodes the input as a whole compressed file */
+static void decodeContainer(const uint8_t *data, size_t size) {
+	FILE *file = fmemopen((void*) data, size, "rb");
+	BlockIndex index;
+
+	if (file == NULL)
+		return;
+	if (readIndex(file, &index) && index.total <= FUZZ_MAX_TOTAL) {
+		unsigned char *out = (unsigned char*) malloc(index.total + 1);
+		if (out != NULL)
+			decodeBlocks(file, &index, out, index.total);
+		free(out);
+	}
+
+	freeIndex(&index);
+	fclose(file);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+	if (size == 0)
+		return 0;
+
+	decodeStream(data, size);
+	decodeContainer(data, size);
+	return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ -------------------------------------
+ File:    fuzz_encode.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+
+ Encodes any input with encodeBlock() and decodes it back with decodeBlock(), aborting
+ when the round trip does not give back the input. The first byte picks the level from
+ its low four bits and tries byte pairs when bit 5 is clear, so seeds starting with 'a'
+ to 'i' are levels 1 to 9, and 'A' to 'I' the same levels with byte pairs. The rest is
+ the input.
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "block.h"
+
+/* Encodes the input as blocks back to back, returns their size */
+static size_t encodeInput(const uint8_t *data, size_t len,
+		const EncodeOptions *options, unsigned char *out) {
+	BlockState state = { NULL };
+	size_t size = 0;
+
+	for (size_t pos = 0; pos < len;) {
+		unsigned int block_len = (unsigned int) (
+				len - pos < options->block_size ?
+						len - pos : options->block_size);
+		unsigned int seg = splitBlock(data + pos, block_len, options);
+		size_t n = 0;
+		BlockType type;
+
+		if (!encodeBlock(data + pos, seg, out + size, &n, options, &state,
+				&type))
+			abort();
+		size += n;
+		pos += seg;
+	}
+
+	freeBlockState(&state);
+	return size;
+}
+
+/* Decodes the blocks back into out, returns whether they make up len characters */
+static bool decodeInput(unsigned char *encoded, size_t size, unsigned char *out,
+		size_t len) {
+	FILE *file = fmemopen(encoded, size, "rb");
+	BlockState state = { NULL };
+	size_t pos = 0;
+	bool success = file != NULL;
+
+	while (success && pos < len) {
+		unsigned int n = 0;
+		BlockType type;
+		success = decodeBlock(file, out + pos, len - pos, &state, &n, &type);
+		pos += n;
+	}
+
+	//nothing may be left over after the last block
+	success = success && fgetc(file) == EOF;
+
+	freeBlockState(&state);
+	if (file != NULL)
+		fclose(file);
+	return success;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+	EncodeOptions options;
+
+	if (size < 2)
+		return 0;
+
+	initializeOptions(&options,
+			MIN_LEVEL + ((data[0] & 0x0F) + MAX_LEVEL - 1) % MAX_LEVEL,
+			(data[0] & 0x20) == 0);
+	data++;
+	size--;
+
+	size_t bound = size
+			+ (size / options.block_size + 1) * getEncodedBound(&options);
+	unsigned char *encoded = (unsigned char*) malloc(bound);
+	unsigned char *decoded = (unsigned char*) malloc(size);
+	if (encoded == NULL || decoded == NULL)
+		abort();
+
+	size_t encoded_size = encodeInput(data, size, &options, encoded);
+	if (!decodeInput(encoded, encoded_size, decoded, size)
+			|| memcmp(decoded, data, size) != 0)
+		abort();
+
+	free(encoded);
+	free(decoded);
+	return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ -------------------------------------
+ File:    fuzz_main.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+
+ FUZZ USAGE: ./fuzz_<harness> [-m <mutations>] <files or directories...>
+
+ Stands in for libFuzzer when the harnesses are built without it. Runs every file, and
+ every file in the directories, through LLVMFuzzerTestOneInput, followed by a fixed
+ sequence of mutations of it: flipped bits, overwritten bytes, truncations and repeated
+ ranges. The sequence is the same on every run, so a failure can be reproduced.
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "corpus.h"
+
+#define DEFAULT_MUTATIONS	256
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static unsigned long long inputs = 0;
+
+/* Changes a copy of the input in one of several ways, returns its new size */
+static size_t mutate(const unsigned char *data, size_t size,
+		unsigned char *out) {
+	memcpy(out, data, size);
+	if (size == 0)
+		return 0;
+
+	size_t pos = nextRandom() % size;
+	switch (nextRandom() % 4) {
+	case 0:
+		out[pos] ^= (unsigned char) (1 << (nextRandom() % 8));
+		return size;
+	case 1:
+		out[pos] = (unsigned char) nextRandom();
+		return size;
+	case 2:
+		return pos;
+	default: {
+		//copies a range over the bytes after it, the size stays the same
+		size_t len = nextRandom() % (size - pos) + 1;
+		size_t to = pos + nextRandom() % (size - pos);
+		if (len > size - to)
+			len = size - to;
+		memmove(out + to, out + pos, len);
+		return size;
+	}
+	}
+}
+
+/* Runs a file and its mutations through the harness */
+static int runFile(const char *name, int mutations) {
+	FILE *file = fopen(name, "rb");
+	if (file == NULL)
+		return 1;
+
+	fseek(file, 0, SEEK_END);
+	size_t size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	unsigned char *data = (unsigned char*) malloc(size + 1);
+	unsigned char *mutated = (unsigned char*) malloc(size + 1);
+	int failed = data == NULL || mutated == NULL
+			|| fread(data, 1, size, file) != size;
+	fclose(file);
+
+	if (!failed) {
+		LLVMFuzzerTestOneInput(data, size);
+		inputs++;
+		for (int m = 0; m < mutations; m++) {
+			size_t n = mutate(data, size, mutated);
+			LLVMFuzzerTestOneInput(mutated, n);
+			inputs++;
+		}
+	}
+
+	free(data);
+	free(mutated);
+	return failed;
+}
+
+/* Runs a file, or every regular file in a directory */
+static int runPath(const char *path, int mutations) {
+	struct stat info;
+	if (stat(path, &info) != 0)
+		return 1;
+	if (!S_ISDIR(info.st_mode))
+		return runFile(path, mutations);
+
+	//sorted, so the mutations are the same whatever order the directory lists them in
+	struct dirent **entries = NULL;
+	int n = scandir(path, &entries, NULL, alphasort);
+	int failed = n < 0;
+
+	for (int i = 0; i < n; i++) {
+		char name[4096];
+		snprintf(name, sizeof(name), "%s/%s", path, entries[i]->d_name);
+		if (stat(name, &info) == 0 && S_ISREG(info.st_mode))
+			failed |= runFile(name, mutations);
+		free(entries[i]);
+	}
+
+	free(entries);
+	return failed;
+}
+
+/* Main Function */
+int main(int argc, char **argv) {
+	int mutations = DEFAULT_MUTATIONS;
+	int failed = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+			mutations = atoi(argv[++i]);
+		} else if (runPath(argv[i], mutations) != 0) {
+			printf("ERROR: Cannot read %s\n", argv[i]);
+			failed = 1;
+		}
+	}
+
+	printf("%llu inputs\n", inputs);
+	return failed || inputs == 0;
+}
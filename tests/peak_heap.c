@@ -0,0 +1,84 @@
+/*
+ -------------------------------------
+ File:    peak_heap.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+
+ PEAK HEAP USAGE: LD_PRELOAD=./libpeak_heap.so PEAK_HEAP_FILE=<file> <command>
+
+ Tracks the heap a program holds through malloc, calloc, realloc and free, counting
+ each allocation with the header glibc keeps in front of it, and writes the most it
+ held at once to PEAK_HEAP_FILE when the program exits.
+
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <malloc.h>
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static atomic_llong live = 0;
+static atomic_llong peak = 0;
+
+/* Returns the heap an allocation takes, its header included */
+static long long getChunkSize(void *ptr) {
+	return (long long) (malloc_usable_size(ptr) + sizeof(size_t));
+}
+
+static void track(void *ptr) {
+	if (ptr == NULL)
+		return;
+	long long now = atomic_fetch_add(&live, getChunkSize(ptr))
+			+ getChunkSize(ptr);
+	long long old = atomic_load(&peak);
+	while (now > old && !atomic_compare_exchange_weak(&peak, &old, now))
+		;
+}
+
+static void untrack(void *ptr) {
+	if (ptr != NULL)
+		atomic_fetch_sub(&live, getChunkSize(ptr));
+}
+
+void* malloc(size_t size) {
+	void *ptr = __libc_malloc(size);
+	track(ptr);
+	return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+	void *ptr = __libc_calloc(count, size);
+	track(ptr);
+	return ptr;
+}
+
+void* realloc(void *ptr, size_t size) {
+	untrack(ptr);
+	void *moved = __libc_realloc(ptr, size);
+	//a failed realloc leaves the old allocation in place
+	track(moved != NULL || size == 0 ? moved : ptr);
+	return moved;
+}
+
+void free(void *ptr) {
+	untrack(ptr);
+	__libc_free(ptr);
+}
+
+__attribute__((destructor)) static void writePeak(void) {
+	const char *name = getenv("PEAK_HEAP_FILE");
+	FILE *file = name != NULL ? fopen(name, "w") : NULL;
+	if (file != NULL) {
+		fprintf(file, "%lld\n", atomic_load(&peak));
+		fclose(file);
+	}
+}
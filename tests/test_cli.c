@@ -0,0 +1,212 @@
+/*
+ -------------------------------------
+ File:    test_cli.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+
+ TEST USAGE: ./test_cli <huffman> <work directory>
+
+ Runs the tool on 9 MB of generated logs, enough blocks at -5 and -5 -w for encoding and
+ appending to go through io_uring, while -9 keeps to blocking I/O. Checks with verify
+ that encoding the whole input, and encoding its first megabyte then appending the rest,
+ give back the input, and that an append stopped by a file size limit fails and leaves
+ the old file as it was. Also checks the estimate against what encoding writes.
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "corpus.h"
+#include "tool.h"
+
+#define INPUT_SIZE	(9 << 20)
+#define PREFIX_SIZE	(1 << 20)	//characters compressed before appending the rest
+#define FAIL_ROOM	(1 << 20)	//bytes a failing append may add to the old file
+#define ESTIMATE_ERROR	3	//percent the estimate may be off from the encoded size
+
+typedef bool (*Check)(const char *level, bool pairs);
+
+typedef struct CliCase {
+	const char *name;
+	Check check;
+	const char *level;
+	bool pairs;
+} CliCase;
+
+static char *tool_path;
+static char input[4096], prefix[4096], encoded[4096], report[4096];
+
+/* Writes data to a file */
+static bool writeFile(const char *name, const unsigned char *data, size_t len) {
+	FILE *file = fopen(name, "wb");
+	if (file == NULL)
+		return false;
+	bool success = fwrite(data, 1, len, file) == len;
+	return fclose(file) == 0 && success;
+}
+
+/* Reads a whole file, returns NULL when it cannot */
+static unsigned char* readFile(const char *name, size_t *len) {
+	FILE *file = fopen(name, "rb");
+	unsigned char *data = NULL;
+
+	if (file == NULL)
+		return NULL;
+	fseek(file, 0, SEEK_END);
+	*len = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	if ((data = (unsigned char*) malloc(*len + 1)) != NULL
+			&& fread(data, 1, *len, file) != *len) {
+		free(data);
+		data = NULL;
+	}
+	fclose(file);
+	return data;
+}
+
+/* Returns the size of a file, 0 when it cannot be read */
+static unsigned long long getFileSize(const char *name) {
+	size_t len = 0;
+	unsigned char *data = readFile(name, &len);
+	free(data);
+	return data != NULL ? len : 0;
+}
+
+/* Runs a mode of the tool on a file, and on a compressed file unless it estimates.
+ The level is left out when it is NULL, returns the exit code of the tool */
+static int run(const char *mode, const char *level, bool pairs, char *in,
+		char *out, const ToolOptions *options) {
+	static const ToolOptions defaults = { NULL, NULL, 0 };
+	char *tool[8];
+	int n = 0;
+
+	tool[n++] = tool_path;
+	tool[n++] = (char*) mode;
+	if (level != NULL)
+		tool[n++] = (char*) level;
+	if (pairs)
+		tool[n++] = "-w";
+	tool[n++] = in;
+	if (out != NULL)
+		tool[n++] = out;
+	tool[n] = NULL;
+	return runTool(tool, options != NULL ? options : &defaults);
+}
+
+/* Encodes the whole input and verifies it */
+static bool checkEncode(const char *level, bool pairs) {
+	return run("encode", level, pairs, input, encoded, NULL) == 0
+			&& run("verify", NULL, false, input, encoded, NULL) == 0;
+}
+
+/* Encodes the start of the input, appends the rest and verifies the whole input */
+static bool checkAppend(const char *level, bool pairs) {
+	return run("encode", level, pairs, prefix, encoded, NULL) == 0
+			&& run("append", level, pairs, input, encoded, NULL) == 0
+			&& run("verify", NULL, false, input, encoded, NULL) == 0;
+}
+
+/* Appends the rest of the input to the compressed start of it with too little room to
+ write it, the append has to fail and leave the old file verifying as before */
+static bool checkFailedAppend(const char *level, bool pairs) {
+	ToolOptions limited = { NULL, NULL, 0 };
+	size_t before_len = 0, after_len = 0;
+	bool success = false;
+
+	if (run("encode", level, pairs, prefix, encoded, NULL) != 0)
+		return false;
+	unsigned char *before = readFile(encoded, &before_len);
+	limited.file_limit = before_len + FAIL_ROOM;
+
+	if (before != NULL && run("append", level, pairs, input, encoded, &limited) > 0) {
+		unsigned char *after = readFile(encoded, &after_len);
+		success = after != NULL && after_len == before_len
+				&& memcmp(after, before, before_len) == 0
+				&& run("verify", NULL, false, prefix, encoded, NULL) == 0;
+		free(after);
+	}
+	free(before);
+	return success;
+}
+
+/* Estimates the input and compares it with the size encoding it gives */
+static bool checkEstimate(const char *level, bool pairs) {
+	ToolOptions printed = { NULL, report, 0 };
+	unsigned long long estimate = 0;
+	char line[256];
+
+	if (run("encode", level, pairs, input, encoded, NULL) != 0
+			|| run("estimate", level, pairs, input, NULL, &printed) != 0)
+		return false;
+
+	FILE *file = fopen(report, "r");
+	while (file != NULL && fgets(line, sizeof(line), file) != NULL)
+		sscanf(line, "Estimated Output: %llu", &estimate);
+	if (file != NULL)
+		fclose(file);
+
+	unsigned long long size = getFileSize(encoded);
+	double error = 100.0 * ((double) estimate - size) / size;
+	printf("estimate %s%s: %llu bytes, encoded %llu bytes\n", level,
+			pairs ? " -w" : "", estimate, size);
+	return size > 0 && error <= ESTIMATE_ERROR && error >= -ESTIMATE_ERROR;
+}
+
+/* Main Function */
+int main(int argc, char **argv) {
+	static const CliCase cases[] = {
+		{ "encode", checkEncode, "-5", false },
+		{ "encode", checkEncode, "-5", true },
+		{ "append", checkAppend, "-5", false },
+		{ "append", checkAppend, "-5", true },
+		{ "append", checkAppend, "-9", false },
+		{ "failed append", checkFailedAppend, "-5", false },
+		{ "failed append", checkFailedAppend, "-5", true },
+		{ "failed append", checkFailedAppend, "-9", false },
+		{ "estimate", checkEstimate, "-1", false },
+		{ "estimate", checkEstimate, "-5", true }
+	};
+	int failures = 0;
+
+	if (argc != 3) {
+		printf("TEST USAGE: ./test_cli <huffman> <work directory>\n");
+		return 1;
+	}
+	tool_path = argv[1];
+	snprintf(input, sizeof(input), "%s/cli.txt", argv[2]);
+	snprintf(prefix, sizeof(prefix), "%s/cli_prefix.txt", argv[2]);
+	snprintf(encoded, sizeof(encoded), "%s/cli.huf", argv[2]);
+	snprintf(report, sizeof(report), "%s/cli_estimate.txt", argv[2]);
+
+	unsigned char *data = (unsigned char*) malloc(INPUT_SIZE);
+	if (data == NULL)
+		return 1;
+	makeLog(data, INPUT_SIZE);
+	if (!writeFile(input, data, INPUT_SIZE)
+			|| !writeFile(prefix, data, PREFIX_SIZE)) {
+		printf("ERROR: Cannot write %s\n", input);
+		free(data);
+		return 1;
+	}
+	free(data);
+
+	for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+		const CliCase *test = &cases[c];
+		bool success = test->check(test->level, test->pairs);
+		printf("%s %s %s%s\n", success ? "PASS" : "FAIL", test->name,
+				test->level, test->pairs ? " -w" : "");
+		failures += !success;
+	}
+
+	remove(input);
+	remove(prefix);
+	remove(encoded);
+	remove(report);
+	return failures > 0;
+}
@@ -0,0 +1,144 @@
+/*
+ -------------------------------------
+ File:    test_memory.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+
+ TEST USAGE: ./test_memory <huffman> <peak heap library> <work directory>
+
+ Runs the tool on 2 MB of random bytes with --memory-limit, with the peak heap library
+ preloaded, and fails when a mode fails or its heap ever goes over the limit. Random
+ bytes have every byte pair, so -w builds the largest trees there are.
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "corpus.h"
+#include "tool.h"
+
+#define INPUT_SIZE	(1 << 21)
+
+typedef struct MemoryCase {
+	const char *limit;
+	size_t bytes;
+	const char *args[4];	//mode and options, the files are added after them
+} MemoryCase;
+
+/* Writes the random input */
+static bool writeInput(const char *name) {
+	unsigned char *data = (unsigned char*) malloc(INPUT_SIZE);
+	FILE *file = fopen(name, "wb");
+	bool success = data != NULL && file != NULL;
+
+	if (success) {
+		makeRandom(data, INPUT_SIZE);
+		success = fwrite(data, 1, INPUT_SIZE, file) == INPUT_SIZE;
+	}
+	if (file != NULL)
+		success = fclose(file) == 0 && success;
+	free(data);
+	return success;
+}
+
+/* Runs the tool with the peak heap library, returns the peak or -1 when it fails */
+static long long runPeak(char **argv, const char *library, const char *peak) {
+	char preload[4096], peak_file[4096];
+	const char *env[] = { preload, peak_file, NULL };
+	ToolOptions options = { env, NULL, 0 };
+	FILE *file = NULL;
+	long long bytes = -1;
+
+	snprintf(preload, sizeof(preload), "LD_PRELOAD=%s", library);
+	snprintf(peak_file, sizeof(peak_file), "PEAK_HEAP_FILE=%s", peak);
+	remove(peak);
+	//only the result matters, not what the tool prints
+	if (runTool(argv, &options) != 0)
+		return -1;
+	if ((file = fopen(peak, "r")) != NULL) {
+		if (fscanf(file, "%lld", &bytes) != 1)
+			bytes = -1;
+		fclose(file);
+	}
+	return bytes;
+}
+
+/* Main Function */
+int main(int argc, char **argv) {
+	static const MemoryCase cases[] = {
+		{ "4M", 4 << 20, { "encode", "-5", "-w" } },
+		{ "4M", 4 << 20, { "encode", "-9", "-w" } },
+		{ "4M", 4 << 20, { "encode", "-1" } },
+		{ "1M", 1 << 20, { "encode", "-5" } },
+		{ "32M", 32 << 20, { "encode", "-5", "-w" } },
+		{ "4M", 4 << 20, { "estimate", "-w" } },
+		{ "32M", 32 << 20, { "estimate", "-w" } },
+		{ "4M", 4 << 20, { "decode" } },
+		{ "4M", 4 << 20, { "verify" } }
+	};
+	char input[4096], encoded[4096], decoded[4096], peak[4096];
+	int failures = 0;
+
+	if (argc != 4) {
+		printf("TEST USAGE: ./test_memory <huffman> <peak heap library> <work directory>\n");
+		return 1;
+	}
+	snprintf(input, sizeof(input), "%s/random.bin", argv[3]);
+	snprintf(encoded, sizeof(encoded), "%s/random.huf", argv[3]);
+	snprintf(decoded, sizeof(decoded), "%s/random.out", argv[3]);
+	snprintf(peak, sizeof(peak), "%s/peak.txt", argv[3]);
+	if (!writeInput(input)) {
+		printf("ERROR: Cannot write %s\n", input);
+		return 1;
+	}
+
+	for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+		const MemoryCase *test = &cases[c];
+		char *tool[12];
+		int n = 0;
+
+		tool[n++] = argv[1];
+		for (int i = 0; i < 4 && test->args[i] != NULL; i++)
+			tool[n++] = (char*) test->args[i];
+		tool[n++] = "--memory-limit";
+		tool[n++] = (char*) test->limit;
+
+		//decoding reads what the encoding before it wrote
+		if (strcmp(test->args[0], "decode") == 0) {
+			tool[n++] = encoded;
+			tool[n++] = decoded;
+		} else if (strcmp(test->args[0], "verify") == 0) {
+			tool[n++] = input;
+			tool[n++] = encoded;
+		} else {
+			tool[n++] = input;
+			if (strcmp(test->args[0], "estimate") != 0)
+				tool[n++] = encoded;
+		}
+		tool[n] = NULL;
+
+		long long bytes = runPeak(tool, argv[2], peak);
+		bool success = bytes >= 0 && (size_t) bytes <= test->bytes;
+		printf("%s", success ? "PASS" : "FAIL");
+		for (int i = 1; i < n; i++)
+			if (tool[i] != input && tool[i] != encoded && tool[i] != decoded)
+				printf(" %s", tool[i]);
+		if (bytes >= 0)
+			printf(": peak heap %lld bytes\n", bytes);
+		else
+			printf(": failed\n");
+		failures += !success;
+	}
+
+	remove(input);
+	remove(encoded);
+	remove(decoded);
+	remove(peak);
+	return failures > 0;
+}
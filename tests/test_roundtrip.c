@@ -0,0 +1,177 @@
+/*
+ -------------------------------------
+ File:    test_roundtrip.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+
+ TEST USAGE: ./test_roundtrip
+
+ Encodes generated text, random bytes, runs and a mix of the three into compressed files
+ at -1, -5 and -9, with and without byte pairs, and decodes them back with readIndex()
+ and decodeBlocks(). Lengths cover 0, 1 and 2 characters, odd lengths and both sides of
+ the chunk and block sizes of every level. Fails when a file does not decode back to its
+ input, or when a level never writes one of the block types it should.
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "block.h"
+#include "container.h"
+#include "corpus.h"
+
+#define MAX_LENGTHS	16
+
+typedef void (*Generator)(unsigned char*, size_t);
+
+/* Fills the data with a single repeated character */
+static void makeRun(unsigned char *data, size_t len) {
+	memset(data, 'x', len);
+}
+
+/* Fills the data with text, random bytes and runs in turn, 3 KB at a time */
+static void makeMixed(unsigned char *data, size_t len) {
+	Generator parts[] = { makeText, makeText, makeRandom, makeText, makeRun };
+	for (size_t pos = 0, i = 0; pos < len; pos += 3 << 10, i++) {
+		size_t n = len - pos < 3 << 10 ? len - pos : 3 << 10;
+		parts[i % 5](data + pos, n);
+	}
+}
+
+/* Writes data as a compressed file the way the encoder does, one block at a time split
+ where the level splits it */
+static bool encodeData(const unsigned char *data, size_t len,
+		const EncodeOptions *options, FILE *file) {
+	unsigned char *encoded = (unsigned char*) malloc(getEncodedBound(options));
+	BlockState state = { NULL };
+	BlockIndex index;
+	bool success = encoded != NULL;
+
+	initializeIndex(&index);
+	fwrite(FILE_MAGIC, 1, MAGIC_SIZE, file);
+
+	for (size_t start = 0; success && start < len;) {
+		unsigned int block_len = (unsigned int) (
+				len - start < options->block_size ?
+						len - start : options->block_size);
+		size_t size = 0;
+
+		for (unsigned int pos = 0; success && pos < block_len;) {
+			unsigned int seg = splitBlock(data + start + pos, block_len - pos,
+					options);
+			unsigned long long offset = ftell(file) + size;
+			size_t n = 0;
+			BlockType type;
+
+			success = encodeBlock(data + start + pos, seg, encoded + size, &n,
+					options, &state, &type)
+					&& addBlockEntry(&index, offset, seg, type);
+			size += n;
+			pos += seg;
+		}
+
+		success = success && fwrite(encoded, 1, size, file) == size;
+		start += block_len;
+	}
+
+	success = success && writeIndex(file, &index);
+
+	freeBlockState(&state);
+	freeIndex(&index);
+	free(encoded);
+	return success && fflush(file) == 0;
+}
+
+/* Round trips data through a compressed file, counting the blocks of each type */
+static bool roundTrip(const unsigned char *data, size_t len,
+		const EncodeOptions *options, unsigned int *types) {
+	FILE *file = tmpfile();
+	BlockIndex index;
+	unsigned char *decoded = (unsigned char*) malloc(len + 1);
+	bool success = file != NULL && decoded != NULL
+			&& encodeData(data, len, options, file) && readIndex(file, &index);
+
+	if (success) {
+		success = index.total == len
+				&& decodeBlocks(file, &index, decoded, len)
+				&& memcmp(decoded, data, len) == 0;
+		for (unsigned int i = 0; i < index.count; i++)
+			types[index.entries[i].type]++;
+		freeIndex(&index);
+	}
+
+	if (file != NULL)
+		fclose(file);
+	free(decoded);
+	return success;
+}
+
+/* Fills lengths with the sizes worth testing at a level, returns how many there are.
+ Levels that do not split get the sizes around 4 KB instead of around a chunk */
+static int getLengths(const EncodeOptions *options, size_t *lengths) {
+	size_t block = options->block_size;
+	size_t chunk = options->split_chunk > 0 ? options->split_chunk : 4096;
+	size_t all[] = { 0, 1, 2, 3, 7, 255, chunk - 1, chunk, chunk + 1,
+			block - 1, block, block + 1, 2 * block + 1, 3 * block };
+
+	memcpy(lengths, all, sizeof(all));
+	return sizeof(all) / sizeof(all[0]);
+}
+
+/* Main Function */
+int main() {
+	static const char *names[] = { "text", "random", "run", "mixed" };
+	Generator makers[] = { makeText, makeRandom, makeRun, makeMixed };
+	int levels[] = { MIN_LEVEL, DEFAULT_LEVEL, MAX_LEVEL };
+	int failures = 0;
+	int trips = 0;
+
+	for (int l = 0; l < 3; l++) {
+		for (int pairs = 0; pairs <= 1; pairs++) {
+			EncodeOptions options;
+			unsigned int types[BLOCK_REPEAT + 1] = { 0 };
+			size_t lengths[MAX_LENGTHS];
+
+			initializeOptions(&options, levels[l], pairs);
+			int nlengths = getLengths(&options, lengths);
+			unsigned char *data = (unsigned char*) malloc(
+					lengths[nlengths - 1] + 1);
+			if (data == NULL)
+				return 1;
+
+			for (int g = 0; g < 4; g++) {
+				for (int i = 0; i < nlengths; i++) {
+					makers[g](data, lengths[i]);
+					if (!roundTrip(data, lengths[i], &options, types)) {
+						printf("FAIL -%d%s %s, %zu characters\n", levels[l],
+								pairs ? " -w" : "", names[g], lengths[i]);
+						failures++;
+					}
+					trips++;
+				}
+			}
+			free(data);
+
+			//every level writes each type, byte pairs only where the level tries them
+			for (int t = BLOCK_RAW; t <= BLOCK_REPEAT; t++) {
+				bool expected = t != BLOCK_HUFFMAN16 || options.word_symbols;
+				if (expected != (types[t] > 0)) {
+					printf("FAIL -%d%s wrote %u %s blocks\n", levels[l],
+							pairs ? " -w" : "", types[t],
+							blockTypeName((BlockType) t));
+					failures++;
+				}
+			}
+		}
+	}
+
+	clearTableCache();
+	printf("%d round trips, %d failures\n", trips, failures);
+	return failures > 0;
+}
@@ -0,0 +1,52 @@
+/*
+ -------------------------------------
+ File:    tool.c
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+
+ Runs the command line tool from the tests, in a child process set up by ToolOptions.
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "tool.h"
+
+/* Runs the tool and waits for it, returns its exit code or -1 when it did not exit */
+int runTool(char **argv, const ToolOptions *options) {
+	int status = 0;
+
+	fflush(stdout);
+	pid_t pid = fork();
+	if (pid == 0) {
+		for (int i = 0; options->env != NULL && options->env[i] != NULL; i++)
+			if (putenv(strdup(options->env[i])) != 0)
+				_exit(127);
+		if (freopen(options->output != NULL ? options->output : "/dev/null",
+				"w", stdout) == NULL)
+			_exit(127);
+
+		//writes past the limit fail with EFBIG instead of killing the tool
+		if (options->file_limit > 0) {
+			struct rlimit limit = { options->file_limit, options->file_limit };
+			signal(SIGXFSZ, SIG_IGN);
+			if (setrlimit(RLIMIT_FSIZE, &limit) != 0)
+				_exit(127);
+		}
+		execv(argv[0], argv);
+		_exit(127);
+	}
+
+	if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+		return -1;
+	return WEXITSTATUS(status);
+}
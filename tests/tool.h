@@ -0,0 +1,22 @@
+/*
+ -------------------------------------
+ File:    tool.h
+ Project: Huffman TXT Compressor
+ -------------------------------------
+ Author:	Roy Ceyleon
+ Version:	2026-10-19
+ -------------------------------------
+ */
+
+#ifndef TOOL_H_
+#define TOOL_H_
+
+typedef struct ToolOptions {
+	const char *const *env;	//NAME=value settings added to the environment, NULL ended
+	const char *output;	//file the tool prints to, NULL throws it away
+	unsigned long long file_limit;	//largest file the tool may write, 0 for no limit
+} ToolOptions;
+
+int runTool(char **argv, const ToolOptions *options);
+
+#endif /* TOOL_H_ */